@@ -0,0 +1,495 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#include "bench_utils.h"
+
+#include "nanofmt/format.h"
+#include "nanofmt/memory_buffer.h"
+
+#include <cstdint>
+
+namespace {
+    using namespace NANOFMT_NS;
+
+    constexpr char long_text[] =
+        "the quick brown fox jumps over the lazy dog; the quick brown fox jumps over the lazy dog; "
+        "the quick brown fox jumps over the lazy dog; the quick brown fox jumps over the lazy dog; "
+        "the quick brown fox jumps over the lazy dog; the quick brown fox jumps over the lazy dog; "
+        "the quick brown fox jumps over the lazy dog; the quick brown fox jumps over the lazy dog; "
+        "the quick brown fox jumps over the lazy dog; the quick brown fox jumps.";
+
+    // scans and copies literal text a byte at a time, as vformat once did
+    //
+    char* reference_copy_literal(char* dest, char const* end, char const* first, char const* last) noexcept {
+        char const* input = first;
+        while (input != last && *input != '{') {
+            ++input;
+        }
+        return copy_to_n(dest, end, first, input - first);
+    }
+
+    struct color {
+        unsigned char red = 0;
+        unsigned char green = 0;
+        unsigned char blue = 0;
+    };
+} // namespace
+
+// accepts [#][x|d][;separator], e.g. {:#x} or {:d;,}
+//
+template <>
+struct NANOFMT_NS::formatter<color> {
+    bool hash = false;
+    bool hex = true;
+    char separator = '\0';
+
+    char const* parse(char const* in, char const* end) noexcept {
+        if (in != end && *in == '#') {
+            hash = true;
+            ++in;
+        }
+        if (in != end && (*in == 'x' || *in == 'd')) {
+            hex = *in++ == 'x';
+        }
+        if (in != end && *in == ';' && in + 1 != end) {
+            separator = in[1];
+            in += 2;
+        }
+        return in;
+    }
+
+    void format(color value, format_output& out) noexcept {
+        if (hash) {
+            out.put('#');
+        }
+        unsigned char const channels[] = {value.red, value.green, value.blue};
+        for (int index = 0; index != 3; ++index) {
+            if (index != 0 && separator != '\0') {
+                out.put(separator);
+            }
+            if (hex) {
+                out.format("{:02x}", channels[index]);
+            }
+            else {
+                out.format("{}", channels[index]);
+            }
+        }
+    }
+};
+
+NANOFMT_BENCHMARK("format.compiled") {
+    char buffer[256];
+    std::uint64_t counter = 0;
+
+    bench::measure("format_to_n runtime string", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            "request {} from {:>8} took {:6d}us ({:#x})",
+            counter,
+            "client",
+            static_cast<int>(counter % 5000),
+            static_cast<unsigned>(counter));
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n NANOFMT_COMPILE", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            NANOFMT_COMPILE("request {} from {:>8} took {:6d}us ({:#x})"),
+            counter,
+            "client",
+            static_cast<int>(counter % 5000),
+            static_cast<unsigned>(counter));
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.prepared") {
+    char buffer[256];
+    std::uint64_t counter = 0;
+
+    // a string that is only known at runtime, as loaded from a config
+    static char const* volatile source = "{} items in {:>10} ({:6d} bytes, {:#x})";
+    format_string const runtime{source};
+    prepared_format<> const prepared{runtime};
+
+    bench::measure("format_to_n runtime string", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            runtime,
+            counter,
+            "queue",
+            static_cast<int>(counter % 5000),
+            static_cast<unsigned>(counter));
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n prepared_format", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            prepared,
+            counter,
+            "queue",
+            static_cast<int>(counter % 5000),
+            static_cast<unsigned>(counter));
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.literals") {
+    char buffer[512];
+    unsigned counter = 0;
+
+    // from mostly arguments to mostly literal text, as in log templates
+    //
+    bench::measure("format_to_n 3 args, 4 chars of text", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(buffer, sizeof buffer, "{}:{}:{}", counter, counter, counter);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n 1 arg, 40 chars of text", 10'000'000, [&] {
+        ++counter;
+        char* const end =
+            format_to_n(buffer, sizeof buffer, "connection accepted on listener socket {}", counter);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n 2 args, 200 chars of text", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            "subsystem startup complete: the asset cache has been warmed, shader variants were loaded from the "
+            "pipeline cache, and {} background workers are now waiting for jobs from the scheduler queue with "
+            "id {}",
+            counter,
+            counter);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n 0 args, 400 chars of text", 10'000'000, [&] {
+        char* const end = format_to_n(buffer, sizeof buffer, long_text);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("reference byte loop, 400 chars of text", 10'000'000, [&] {
+        char* const end =
+            reference_copy_literal(buffer, buffer + sizeof buffer, long_text, long_text + sizeof long_text - 1);
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.custom") {
+    char buffer[256];
+    unsigned counter = 0;
+
+    static char const* volatile source = "fg {:#x} bg {:d;,} border {:#x}";
+    format_string const runtime{source};
+    prepared_format<> const prepared{runtime};
+
+    bench::measure("format_to_n runtime string", 10'000'000, [&] {
+        ++counter;
+        color const shade{static_cast<unsigned char>(counter), 0x40, 0x80};
+        char* const end = format_to_n(buffer, sizeof buffer, runtime, shade, shade, shade);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n prepared_format", 10'000'000, [&] {
+        ++counter;
+        color const shade{static_cast<unsigned char>(counter), 0x40, 0x80};
+        char* const end = format_to_n(buffer, sizeof buffer, prepared, shade, shade, shade);
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.args") {
+    char buffer[256];
+    unsigned counter = 0;
+
+    // a typical structured log line
+    //
+    bench::measure("format_to_n 10 args", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            "{} {} [{}:{}] {} id={} len={} flags={:#x} retry={} ok={}",
+            counter,
+            "net",
+            "socket.cpp",
+            120,
+            'W',
+            counter * 3u,
+            static_cast<long>(counter % 1500),
+            counter & 0xffu,
+            counter % 3,
+            (counter & 1) != 0);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_inline_to_n 10 args", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_inline_to_n(
+            buffer,
+            sizeof buffer,
+            "{} {} [{}:{}] {} id={} len={} flags={:#x} retry={} ok={}",
+            counter,
+            "net",
+            "socket.cpp",
+            120,
+            'W',
+            counter * 3u,
+            static_cast<long>(counter % 1500),
+            counter & 0xffu,
+            counter % 3,
+            (counter & 1) != 0);
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.dynamic") {
+    char buffer[256];
+    unsigned counter = 0;
+
+    // table cells whose column width is only known at runtime
+    //
+    bench::measure("format_to_n nested width", 10'000'000, [&] {
+        ++counter;
+        int const width = 8 + static_cast<int>(counter % 8);
+        char* const end = format_to_n(buffer, sizeof buffer, "|{:>{}}|{:>{}}|", counter, width, "name", width);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n literal width", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(buffer, sizeof buffer, "|{:>12}|{:>12}|", counter, "name");
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("reference format then pad", 10'000'000, [&] {
+        ++counter;
+        int const width = 8 + static_cast<int>(counter % 8);
+        char cell[32];
+        char* pos = buffer;
+        char* const last = buffer + sizeof buffer;
+        pos = put(pos, last, '|');
+        std::size_t length = format_to_n(cell, sizeof cell, "{}", counter) - cell;
+        pos = fill_n(pos, last, ' ', width > static_cast<int>(length) ? width - length : 0);
+        pos = copy_to_n(pos, last, cell, length);
+        pos = put(pos, last, '|');
+        length = format_to_n(cell, sizeof cell, "{}", "name") - cell;
+        pos = fill_n(pos, last, ' ', width > static_cast<int>(length) ? width - length : 0);
+        pos = copy_to_n(pos, last, cell, length);
+        pos = put(pos, last, '|');
+        bench::do_not_optimize(pos);
+    });
+}
+
+NANOFMT_BENCHMARK("format.named") {
+    char buffer[256];
+    unsigned counter = 0;
+
+    // a log line whose fields are referred to by name, as a translated
+    // message might reorder them
+    //
+    bench::measure("format_to_n named", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            "{user}@{host}: {count} requests",
+            arg("count", counter),
+            arg("host", "example"),
+            arg("user", "root"));
+        bench::do_not_optimize(end);
+    });
+
+    static prepared_format<> const prepared("{user}@{host}: {count} requests");
+    bench::measure("format_to_n prepared named", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            prepared,
+            arg("count", counter),
+            arg("host", "example"),
+            arg("user", "root"));
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n positional", 10'000'000, [&] {
+        ++counter;
+        char* const end = format_to_n(buffer, sizeof buffer, "{2}@{1}: {0} requests", counter, "example", "root");
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.sink") {
+    unsigned counter = 0;
+    std::size_t written = 0;
+
+    // a line longer than the chunk, written out in pieces through a
+    // callback, against measuring it first and formatting it whole
+    //
+    auto const consume = [](void* context, char const* data, std::size_t length) {
+        bench::do_not_optimize(data);
+        *static_cast<std::size_t*>(context) += length;
+    };
+
+    bench::measure("format_to sink 64-byte chunk", 5'000'000, [&] {
+        ++counter;
+        char chunk[64];
+        format_sink sink(chunk, consume, &written);
+        format_output out = sink.output();
+        format_to(out, "{:>24}|{:<24}|{}|{:x}|{}", "first column", "second column", counter, counter, long_text);
+        out.flush();
+    });
+
+    bench::measure("format_length then format_to_n", 5'000'000, [&] {
+        ++counter;
+        char buffer[512];
+        std::size_t const length =
+            format_length("{:>24}|{:<24}|{}|{:x}|{}", "first column", "second column", counter, counter, long_text);
+        char* const end = format_to_n(
+            buffer,
+            length < sizeof buffer ? length : sizeof buffer,
+            "{:>24}|{:<24}|{}|{:x}|{}",
+            "first column",
+            "second column",
+            counter,
+            counter,
+            long_text);
+        consume(&written, buffer, end - buffer);
+    });
+    bench::do_not_optimize(written);
+}
+
+NANOFMT_BENCHMARK("format.cursor") {
+    unsigned counter = 0;
+
+    // a message spanning many small frames, resumed by a cursor, against
+    // formatting it from the start for each frame and keeping the slice
+    // that frame needs
+    //
+    bench::measure("format_cursor 32-byte frames", 1'000'000, [&] {
+        ++counter;
+        format_cursor cursor("{}|{:>24}|{}|{:x}|{}", long_text, "padded", counter, counter, long_text);
+        while (!cursor.done()) {
+            char frame[32];
+            char* const end = cursor.format_to_n(frame, sizeof frame);
+            bench::do_not_optimize(end);
+        }
+    });
+
+    bench::measure("restart and skip 32-byte frames", 1'000'000, [&] {
+        ++counter;
+        std::size_t offset = 0;
+        for (;;) {
+            char buffer[1024];
+            char* const end = format_to_n(
+                buffer,
+                offset + 32 < sizeof buffer ? offset + 32 : sizeof buffer,
+                "{}|{:>24}|{}|{:x}|{}",
+                long_text,
+                "padded",
+                counter,
+                counter,
+                long_text);
+            char frame[32];
+            std::size_t const length = static_cast<std::size_t>(end - buffer) - offset;
+            bench::do_not_optimize(copy_to_n(frame, frame + sizeof frame, buffer + offset, length));
+            if (length < sizeof frame) {
+                break;
+            }
+            offset += length;
+        }
+    });
+}
+
+NANOFMT_BENCHMARK("format.result") {
+    unsigned counter = 0;
+
+    // the try-a-stack-buffer pattern, where the length decides whether a
+    // larger buffer is needed
+    //
+    bench::measure("format_to_n_result", 10'000'000, [&] {
+        ++counter;
+        char buffer[128];
+        format_result const result =
+            format_to_n_result(buffer, sizeof buffer, "{}: {} of {} ({:.1f}%)", "progress", counter, 1000u, 12.5);
+        bench::do_not_optimize(result.pos);
+        bench::do_not_optimize(result.size);
+    });
+
+    bench::measure("format_length then format_to_n", 10'000'000, [&] {
+        ++counter;
+        char buffer[128];
+        std::size_t const size = format_length("{}: {} of {} ({:.1f}%)", "progress", counter, 1000u, 12.5);
+        char* const end =
+            format_to_n(buffer, sizeof buffer, "{}: {} of {} ({:.1f}%)", "progress", counter, 1000u, 12.5);
+        bench::do_not_optimize(end);
+        bench::do_not_optimize(size);
+    });
+}
+
+NANOFMT_BENCHMARK("format.length") {
+    unsigned counter = 0;
+    char const long_text[] = "a string argument long enough that copying it is not free";
+
+    // measuring a format, compared to actually writing it
+    //
+    bench::measure("format_length", 10'000'000, [&] {
+        ++counter;
+        std::size_t const size =
+            format_length("{:>8}|{:#x}|{:08}|{:30}|{}", counter, counter, -static_cast<int>(counter), "key", long_text);
+        bench::do_not_optimize(size);
+    });
+
+    bench::measure("format_to_n", 10'000'000, [&] {
+        ++counter;
+        char buffer[256];
+        char* const end = format_to_n(
+            buffer,
+            sizeof buffer,
+            "{:>8}|{:#x}|{:08}|{:30}|{}",
+            counter,
+            counter,
+            -static_cast<int>(counter),
+            "key",
+            long_text);
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("format.memory_buffer") {
+    unsigned counter = 0;
+    char const long_text[] = "a string argument long enough that several of them outgrow the inline storage";
+
+    // formatting output of unknown length, in one pass into a growable
+    // buffer, compared to measuring first and then allocating exactly
+    //
+    bench::measure("memory_buffer", 1'000'000, [&] {
+        ++counter;
+        basic_memory_buffer<64> buffer;
+        buffer.format("{}: {} {} {} {}", counter, long_text, long_text, long_text, long_text);
+        bench::do_not_optimize(buffer.data());
+    });
+
+    bench::measure("format_length then format_to_n", 1'000'000, [&] {
+        ++counter;
+        std::size_t const size = format_length("{}: {} {} {} {}", counter, long_text, long_text, long_text, long_text);
+        char* const buffer = new char[size];
+        char* const end =
+            format_to_n(buffer, size, "{}: {} {} {} {}", counter, long_text, long_text, long_text, long_text);
+        bench::do_not_optimize(end);
+        delete[] buffer;
+    });
+}
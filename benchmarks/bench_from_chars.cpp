@@ -0,0 +1,114 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#include "bench_utils.h"
+
+#include "nanofmt/charconv.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    using namespace NANOFMT_NS;
+
+    // formatted integers of mixed lengths, as found in config values and
+    // protocol fields
+    //
+    struct integer_inputs {
+        static constexpr std::size_t count = 1024;
+        char text[count][24] = {};
+        char const* ends[count] = {};
+
+        explicit integer_inputs(int_format fmt) noexcept {
+            std::uint64_t state = 0x9e3779b97f4a7c15ull;
+            for (std::size_t index = 0; index != count; ++index) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                char* const end = to_chars(text[index], text[index] + sizeof text[index] - 1, state >> (state % 60), fmt);
+                *end = '\0';
+                ends[index] = end;
+            }
+        }
+    };
+
+    integer_inputs const decimal_inputs{int_format::decimal};
+    integer_inputs const hex_inputs{int_format::hex};
+
+#if NANOFMT_FLOAT
+    // shortest representations of doubles with full-length significands, as
+    // written by to_chars when recording values for replay
+    //
+    struct double_inputs {
+        static constexpr std::size_t count = 1024;
+        char text[count][32] = {};
+        char const* ends[count] = {};
+
+        double_inputs() noexcept {
+            std::uint64_t state = 0x9e3779b97f4a7c15ull;
+            for (std::size_t index = 0; index != count; ++index) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                double const value = static_cast<double>(state >> 11) * 0x1p-53 * 1e10;
+                char* const end = to_chars(text[index], text[index] + sizeof text[index] - 1, value, float_format::scientific);
+                *end = '\0';
+                ends[index] = end;
+            }
+        }
+    };
+
+    double_inputs const shortest_inputs;
+#endif
+} // namespace
+
+NANOFMT_BENCHMARK("from_chars.integers") {
+    std::size_t index = 0;
+
+    bench::measure("strtoull decimal", 20'000'000, [&] {
+        std::size_t const at = index++ % integer_inputs::count;
+        unsigned long long const value = std::strtoull(decimal_inputs.text[at], nullptr, 10);
+        bench::do_not_optimize(value);
+    });
+
+    bench::measure("from_chars uint64 decimal", 20'000'000, [&] {
+        std::size_t const at = index++ % integer_inputs::count;
+        std::uint64_t value = 0;
+        from_chars_result const result = from_chars(decimal_inputs.text[at], decimal_inputs.ends[at], value);
+        bench::do_not_optimize(result.ptr);
+        bench::do_not_optimize(value);
+    });
+
+    bench::measure("strtoull hex", 20'000'000, [&] {
+        std::size_t const at = index++ % integer_inputs::count;
+        unsigned long long const value = std::strtoull(hex_inputs.text[at], nullptr, 16);
+        bench::do_not_optimize(value);
+    });
+
+    bench::measure("from_chars uint64 hex", 20'000'000, [&] {
+        std::size_t const at = index++ % integer_inputs::count;
+        std::uint64_t value = 0;
+        from_chars_result const result = from_chars(hex_inputs.text[at], hex_inputs.ends[at], value, int_format::hex);
+        bench::do_not_optimize(result.ptr);
+        bench::do_not_optimize(value);
+    });
+}
+
+#if NANOFMT_FLOAT
+NANOFMT_BENCHMARK("from_chars.floating") {
+    std::size_t index = 0;
+
+    bench::measure("strtod shortest", 10'000'000, [&] {
+        std::size_t const at = index++ % double_inputs::count;
+        double const value = std::strtod(shortest_inputs.text[at], nullptr);
+        bench::do_not_optimize(value);
+    });
+
+    bench::measure("from_chars double shortest", 10'000'000, [&] {
+        std::size_t const at = index++ % double_inputs::count;
+        double value = 0;
+        from_chars_result const result = from_chars(shortest_inputs.text[at], shortest_inputs.ends[at], value);
+        bench::do_not_optimize(result.ptr);
+        bench::do_not_optimize(value);
+    });
+}
+#endif
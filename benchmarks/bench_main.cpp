@@ -0,0 +1,25 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#include "bench_utils.h"
+
+#include <cstdio>
+#include <cstring>
+
+// Usage: nanofmt_bench [filter]
+//
+// Runs every benchmark whose name contains filter, or all benchmarks
+// if no filter is provided.
+int main(int argc, char** argv) {
+    using namespace NANOFMT_NS::bench;
+
+    char const* const filter = argc > 1 ? argv[1] : "";
+
+    for (benchmark const* bench = benchmarks(); bench != nullptr; bench = bench->next) {
+        if (std::strstr(bench->name, filter) == nullptr) {
+            continue;
+        }
+        std::printf("%s\n", bench->name);
+        bench->func();
+    }
+    return 0;
+}
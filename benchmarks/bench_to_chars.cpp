@@ -0,0 +1,247 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#include "bench_utils.h"
+
+#include "nanofmt/charconv.h"
+#include "nanofmt/format.h"
+
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+    using namespace NANOFMT_NS;
+
+    // the original one-digit-per-division kernel, kept as a baseline
+    //
+    char* reference_to_chars_decimal(char* dest, char const* end, std::uint64_t value) noexcept {
+        int digits = 1;
+        for (std::uint64_t v = value; v >= 10; v /= 10) {
+            ++digits;
+        }
+        if (end - dest < digits) {
+            return dest;
+        }
+        char* ptr = dest + digits;
+        do {
+            *--ptr = static_cast<char>('0' + (value % 10));
+            value /= 10;
+        } while (value != 0);
+        return dest + digits;
+    }
+
+    // the original one-nibble-per-iteration hex kernel, kept as a baseline
+    //
+    char* reference_to_chars_hex(char* dest, char const* end, std::uint64_t value) noexcept {
+        int shift = 60;
+        while (shift > 0 && (value >> shift) == 0) {
+            shift -= 4;
+        }
+        std::uint64_t mask = std::uint64_t{0xf} << shift;
+        while (mask != 0 && dest != end) {
+            std::uint64_t const nibble = (value & mask) >> shift;
+            *dest++ = static_cast<char>(nibble < 10 ? '0' + nibble : 'a' + nibble - 10);
+            shift -= 4;
+            mask >>= 4;
+        }
+        return dest;
+    }
+
+    // a spread of magnitudes similar to IDs, counters, and sizes
+    //
+    struct decimal_inputs {
+        static constexpr std::size_t count = 1024;
+        std::uint64_t values[count] = {};
+
+        decimal_inputs() noexcept {
+            std::uint64_t state = 0x9e3779b97f4a7c15ull;
+            for (std::uint64_t& value : values) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                value = state >> (state % 60);
+            }
+        }
+    };
+
+    decimal_inputs const inputs;
+} // namespace
+
+NANOFMT_BENCHMARK("to_chars.decimal") {
+    char buffer[32];
+    std::size_t index = 0;
+
+    bench::measure("reference one digit per division", 20'000'000, [&] {
+        char* const end =
+            reference_to_chars_decimal(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count]);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint64", 20'000'000, [&] {
+        char* const end = to_chars(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count]);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint32", 20'000'000, [&] {
+        char* const end =
+            to_chars(buffer, buffer + sizeof buffer, static_cast<std::uint32_t>(inputs.values[index++ % inputs.count]));
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint64 truncated to 8 chars", 20'000'000, [&] {
+        char* const end = to_chars(buffer, buffer + 8, inputs.values[index++ % inputs.count]);
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("to_chars.radix") {
+    char buffer[80];
+    std::size_t index = 0;
+
+    bench::measure("reference hex one nibble per iteration", 20'000'000, [&] {
+        char* const end = reference_to_chars_hex(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count]);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint64 hex", 20'000'000, [&] {
+        char* const end = to_chars(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count], int_format::hex);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint32 hex", 20'000'000, [&] {
+        char* const end = to_chars(
+            buffer,
+            buffer + sizeof buffer,
+            static_cast<std::uint32_t>(inputs.values[index++ % inputs.count]),
+            int_format::hex);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("format_to_n void const*", 20'000'000, [&] {
+        auto const* const pointer = reinterpret_cast<void const*>(inputs.values[index++ % inputs.count]);
+        char* const end = format_to_n(buffer, sizeof buffer, "{}", pointer);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint64 hex_prefixed", 20'000'000, [&] {
+        char* const end =
+            to_chars(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count], int_format::hex_prefixed);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint64 octal", 20'000'000, [&] {
+        char* const end =
+            to_chars(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count], int_format::octal);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars uint64 binary", 20'000'000, [&] {
+        char* const end =
+            to_chars(buffer, buffer + sizeof buffer, inputs.values[index++ % inputs.count], int_format::binary);
+        bench::do_not_optimize(end);
+    });
+}
+
+NANOFMT_BENCHMARK("to_chars_many") {
+    char buffer[32 * 1024];
+
+    bench::measure("to_chars loop over 1024 uint64 with separators", 20'000, [&] {
+        char* pos = buffer;
+        char const* const end = buffer + sizeof buffer;
+        for (std::size_t index = 0; index != inputs.count; ++index) {
+            if (index != 0) {
+                pos = copy_to_n(pos, end, ", ", 2);
+            }
+            pos = to_chars(pos, end, inputs.values[index]);
+        }
+        bench::do_not_optimize(pos);
+    });
+
+    bench::measure("to_chars_many 1024 uint64", 20'000, [&] {
+        to_chars_many_result const result =
+            to_chars_many(buffer, buffer + sizeof buffer, inputs.values, inputs.count, ", ");
+        bench::do_not_optimize(result.ptr);
+    });
+
+    bench::measure("to_chars_many 1024 uint64 hex", 20'000, [&] {
+        to_chars_many_result const result =
+            to_chars_many(buffer, buffer + sizeof buffer, inputs.values, inputs.count, ", ", int_format::hex);
+        bench::do_not_optimize(result.ptr);
+    });
+}
+
+NANOFMT_BENCHMARK("to_chars.float") {
+    char buffer[64];
+    std::size_t index = 0;
+
+    // a metrics-like mix: whole counts, binary fractions like 0.5 or 0.25,
+    // and arbitrary measurements
+    //
+    double metrics[decimal_inputs::count] = {};
+    std::size_t exact_count = 0;
+    for (std::size_t i = 0; i != decimal_inputs::count; ++i) {
+        std::uint64_t const raw = inputs.values[i];
+        switch (i % 4) {
+            case 0:
+            case 1:
+                metrics[i] = static_cast<double>(raw % 100'000);
+                break;
+            case 2:
+                metrics[i] = static_cast<double>(raw % 4096) / 16.0;
+                break;
+            default:
+                metrics[i] = static_cast<double>(raw % 100'000) * 1e-3;
+                break;
+        }
+        double const sixteenths = metrics[i] * 16.0;
+        exact_count += sixteenths == static_cast<double>(static_cast<std::uint64_t>(sixteenths));
+    }
+    std::printf("  exact (fast path) inputs in metrics mix: %.1f%%\n", 100.0 * exact_count / decimal_inputs::count);
+
+    bench::measure("to_chars double general, metrics mix", 10'000'000, [&] {
+        char* const end =
+            to_chars(buffer, buffer + sizeof buffer, metrics[index++ % decimal_inputs::count], float_format::general);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double shortest fixed, integral", 10'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count] % 1'000'000);
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::fixed);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double shortest fixed, non-exact", 10'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count] % 1'000'000) * 1e-3;
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::fixed);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double shortest scientific", 10'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count]) * 1e-7;
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::scientific);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double fixed precision 3", 10'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count]) * 1e-7;
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::fixed, 3);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double scientific precision 6", 10'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count]) * 1e-7;
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::scientific, 6);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double fixed precision 30", 1'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count]) * 1e-7;
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::fixed, 30);
+        bench::do_not_optimize(end);
+    });
+
+    bench::measure("to_chars double hex", 10'000'000, [&] {
+        double const value = static_cast<double>(inputs.values[index++ % inputs.count]) * 1e-7;
+        char* const end = to_chars(buffer, buffer + sizeof buffer, value, float_format::hex);
+        bench::do_not_optimize(end);
+    });
+}
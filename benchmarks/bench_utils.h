@@ -0,0 +1,70 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#pragma once
+
+#include "nanofmt/config.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace NANOFMT_NS::bench {
+    struct benchmark {
+        char const* name = nullptr;
+        void (*func)() = nullptr;
+        benchmark const* next = nullptr;
+    };
+
+    inline benchmark const*& benchmarks() noexcept {
+        static benchmark const* head = nullptr;
+        return head;
+    }
+
+    struct registrar {
+        registrar(benchmark& bench) noexcept {
+            bench.next = benchmarks();
+            benchmarks() = &bench;
+        }
+    };
+
+    /// Prevents the compiler from discarding the computation of value.
+    template <typename T>
+    inline void do_not_optimize(T const& value) noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static_cast<void>(*static_cast<T const volatile*>(&value));
+#endif
+    }
+
+    /// Runs func for the given number of iterations and prints the
+    /// average time per iteration.
+    template <typename FuncT>
+    void measure(char const* label, std::size_t iterations, FuncT&& func) {
+        using clock = std::chrono::steady_clock;
+
+        // warm up caches and branch predictors
+        for (std::size_t i = 0; i != iterations / 10; ++i) {
+            func();
+        }
+
+        auto const start = clock::now();
+        for (std::size_t i = 0; i != iterations; ++i) {
+            func();
+        }
+        auto const elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+        std::printf("  %-52s %10.2f ns/iter\n", label, elapsed / static_cast<double>(iterations));
+    }
+} // namespace NANOFMT_NS::bench
+
+#define NANOFMT_BENCH_CAT2(a, b) a##b
+#define NANOFMT_BENCH_CAT(a, b) NANOFMT_BENCH_CAT2(a, b)
+#define NANOFMT_BENCHMARK_IMPL(func, name)                                                                             \
+    static void func();                                                                                                \
+    static ::NANOFMT_NS::bench::benchmark NANOFMT_BENCH_CAT(func, _bench){name, &func};                                \
+    static ::NANOFMT_NS::bench::registrar NANOFMT_BENCH_CAT(func, _registrar){NANOFMT_BENCH_CAT(func, _bench)};        \
+    static void func()
+
+/// Declares a benchmark group; the body should call bench::measure.
+#define NANOFMT_BENCHMARK(name) NANOFMT_BENCHMARK_IMPL(NANOFMT_BENCH_CAT(nanofmt_benchmark_, __COUNTER__), name)
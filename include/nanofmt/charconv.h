@@ -4,6 +4,8 @@
 
 #include "config.h"
 
+#include <cstddef>
+
 namespace NANOFMT_NS {
     // clang-format off
     /// @brief Format options for integral values.
@@ -12,6 +14,17 @@ namespace NANOFMT_NS {
         hex         = 2, ///< Format in base 16
         hex_upper   = 3, ///< Format in base 16, with uppercase letters
         binary      = 4, ///< Format in base 2
+        octal       = 5, ///< Format in base 8
+        /// Format in base 16, with a 0x prefix
+        hex_prefixed            = hex       | 0b01000,
+        /// Format in base 16, with uppercase letters and a 0X prefix
+        hex_upper_prefixed      = hex_upper | 0b01000,
+        /// Format in base 2, with a 0b prefix
+        binary_prefixed         = binary    | 0b01000,
+        /// Format in base 2, with a 0B prefix
+        binary_upper_prefixed   = binary    | 0b11000,
+        /// Format in base 8, with a 0 prefix for non-zero values
+        octal_prefixed          = octal     | 0b01000,
     };
 
     /// Format options for floating-point values.
@@ -65,6 +78,52 @@ namespace NANOFMT_NS {
     // bools are disallowed, cast to an integer type if a 0 or 1 format is required
     char* to_chars(char* dest, char const* end, bool value, int_format) noexcept = delete;
 
+    /// @brief Result of formatting a list of values with to_chars_many.
+    struct to_chars_many_result {
+        /// One past the last character written.
+        char* ptr = nullptr;
+        /// Number of values that were written in full.
+        std::size_t count = 0;
+    };
+
+#if defined(DOXYGEN_SHOULD_SKIP_THIS)
+    /// @brief Format a list of integer values to the target buffer, with a
+    /// separator between each value.
+    ///
+    /// Only whole values are written; if the buffer runs out, the values
+    /// that did not fit (and their separators) are omitted entirely.
+    ///
+    /// @param buffer target buffer to write characters to.
+    /// @param end the end of the target buffer.
+    /// @param values the values to format.
+    /// @param count the number of values.
+    /// @param separator NUL-terminated string written between values.
+    /// @param fmt formatting options.
+    /// @return one past the last character written, and the number of
+    /// values written.
+    template <typename IntegerT>
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        IntegerT const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt = int_format::decimal) noexcept;
+#else
+    // clang-format off
+    to_chars_many_result to_chars_many(char* dest, char const* end, signed char const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, unsigned char const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, signed short const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, unsigned short const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, signed int const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, unsigned int const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, signed long const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, unsigned long const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, signed long long const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    to_chars_many_result to_chars_many(char* dest, char const* end, unsigned long long const* values, std::size_t count, char const* separator, int_format fmt = int_format::decimal) noexcept;
+    // clang-format on
+#endif
+
 #if defined(DOXYGEN_SHOULD_SKIP_THIS)
     /// @brief Format a single-precision floating point value to the target buffer.
     /// @param buffer target buffer to write characters to.
@@ -101,4 +160,97 @@ namespace NANOFMT_NS {
     char* to_chars(char* dest, char const* end, long double value) noexcept = delete;
     char* to_chars(char* dest, char const* end, long double value, float_format fmt) noexcept = delete;
     char* to_chars(char* dest, char const* end, long double value, float_format fmt, int precision) noexcept = delete;
+
+    /// @brief Errors reported by from_chars.
+    enum class from_chars_error {
+        /// The value was parsed successfully.
+        none = 0,
+        /// The input does not begin with a value in the expected format.
+        invalid_argument,
+        /// The input is a well-formed value that does not fit in the target type.
+        result_out_of_range,
+    };
+
+    /// @brief Result of parsing a value with from_chars.
+    struct from_chars_result {
+        /// One past the last character of the parsed value, or the start of
+        /// the input if no value could be parsed.
+        char const* ptr = nullptr;
+        /// Whether the parse succeeded, and why not if it did not.
+        from_chars_error ec = from_chars_error::none;
+    };
+
+#if defined(DOXYGEN_SHOULD_SKIP_THIS)
+    /// @brief Parse an integer value from the source buffer.
+    ///
+    /// Accepts the output of to_chars with the same int_format: a leading
+    /// minus sign for signed types only, the base prefix for the _prefixed
+    /// formats, and digits of either case for hex. Leading whitespace and a
+    /// plus sign are not accepted. On error, value is left unmodified.
+    ///
+    /// @param first the start of the source buffer.
+    /// @param last the end of the source buffer.
+    /// @param value receives the parsed value.
+    /// @param fmt formatting options.
+    /// @return one past the last character parsed, and an error code.
+    template <typename IntegerT>
+    from_chars_result from_chars(
+        char const* first,
+        char const* last,
+        IntegerT& value,
+        int_format fmt = int_format::decimal) noexcept;
+#else
+    // clang-format off
+    from_chars_result from_chars(char const* first, char const* last, signed char& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, unsigned char& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, signed short& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, unsigned short& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, signed int& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, unsigned int& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, signed long& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, unsigned long& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, signed long long& value, int_format fmt = int_format::decimal) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, unsigned long long& value, int_format fmt = int_format::decimal) noexcept;
+    // clang-format on
+#endif
+
+    // plain char and bool are disallowed, as with to_chars
+    from_chars_result from_chars(char const* first, char const* last, char& value, int_format) noexcept = delete;
+    from_chars_result from_chars(char const* first, char const* last, bool& value, int_format) noexcept = delete;
+
+#if defined(DOXYGEN_SHOULD_SKIP_THIS)
+    /// @brief Parse a floating point value from the source buffer.
+    ///
+    /// The result is the correctly rounded value of the input, with ties to
+    /// even, so the shortest output of to_chars (float_format::fixed or
+    /// float_format::scientific, without a precision) round-trips; output at
+    /// a limited precision, such as float_format::general's default of six
+    /// significant digits, does not. Accepts an optional minus sign, digits
+    /// with an optional decimal point, and an exponent; the
+    /// exponent is required for float_format::scientific and not accepted for
+    /// float_format::fixed. inf, infinity, and nan are accepted in any case.
+    /// Hexadecimal input is not supported. A value that is too large, or
+    /// that is not zero but rounds to zero, is out of range. On error, value
+    /// is left unmodified.
+    ///
+    /// @param first the start of the source buffer.
+    /// @param last the end of the source buffer.
+    /// @param value receives the parsed value.
+    /// @param fmt formatting options.
+    /// @return one past the last character parsed, and an error code.
+    template <typename FloatT>
+    from_chars_result from_chars(
+        char const* first,
+        char const* last,
+        FloatT& value,
+        float_format fmt = float_format::general) noexcept;
+#else
+    // clang-format off
+    from_chars_result from_chars(char const* first, char const* last, float& value, float_format fmt = float_format::general) noexcept;
+    from_chars_result from_chars(char const* first, char const* last, double& value, float_format fmt = float_format::general) noexcept;
+    // clang-format on
+#endif
+
+    // long doubles are not supported
+    from_chars_result from_chars(char const* first, char const* last, long double& value, float_format) noexcept = delete;
 } // namespace NANOFMT_NS
@@ -7,6 +7,8 @@
 #include "config.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 namespace NANOFMT_NS {
@@ -28,6 +30,31 @@ namespace NANOFMT_NS {
     /// Small wrapper to assist in formatting types like std::string_view.
     struct format_string_view;
 
+    /// A format string that is split into literal text and parsed
+    /// replacement fields at compile time.
+    ///
+    /// Create with NANOFMT_COMPILE, or nanofmt::compile<"..."> in C++20.
+    /// Converts to format_string, so it is accepted anywhere a format
+    /// string is.
+    template <typename SourceT>
+    struct compiled_format;
+
+    /// A format string that is split into literal text and parsed
+    /// replacement fields once at runtime, for strings that are only known
+    /// at runtime but are used many times.
+    ///
+    /// Holds up to MaxSegments segments, where each segment is a run of
+    /// literal text optionally followed by a replacement field; a string
+    /// that needs more is formatted as a plain format_string. References
+    /// the source string, which must outlive it. Converts to format_string,
+    /// so it is accepted anywhere a format string is.
+    ///
+    /// Custom formatters are parsed the first time each field is formatted
+    /// and reused afterwards, so an instance must not be used by several
+    /// threads at once.
+    template <std::size_t MaxSegments = 16>
+    struct prepared_format;
+
     /// Wrapper around a destination sequence of characters.
     ///
     /// Counts the number of characters that are written to the buffer,
@@ -35,15 +62,66 @@ namespace NANOFMT_NS {
     ///
     /// Use advance_to to update the pos pointer to ensure the advance field
     /// is updated appropriately.
+    ///
+    /// An output created from a format_sink writes through the sink's chunk
+    /// instead, and is not truncated, except where a formatter writes more
+    /// through pos directly than fits before end.
     struct format_output;
 
-    /// Holds a list of N format_value objects.
+    /// A fixed chunk of memory that a format_output writes into, and a
+    /// callback that is given the chunk's contents whenever it fills.
+    ///
+    /// Allows output of any length to be formatted through a bounded buffer,
+    /// such as a stack array or an arena allocation, in a single pass. The
+    /// callback is also called by format_output::flush, which must be used
+    /// once formatting is done to write out what remains in the chunk. The
+    /// callback must not throw. It may point chunk and capacity at other
+    /// memory before returning, and output then continues there, or set
+    /// chunk to nullptr to end the output, after which formatting only
+    /// counts toward advance. Setting discard drops that many characters
+    /// from the start of the output before any reach the callback.
+    ///
+    /// Each floating-point value is written whole into the chunk when it
+    /// fits, and is otherwise streamed through the chunk from a scratch
+    /// buffer. Each custom formatter writes into a 256-character chunk of
+    /// its own, which is passed on as it fills, so it can always write that
+    /// much through pos directly; it must write any more in pieces, calling
+    /// advance_to after each so that a full chunk is flushed.
+    struct format_sink;
+
+    /// Holds the values of a list of arguments.
     ///
     /// This is primarily meant to be an intermediate that holds onto values
     /// as a temporary object, and will usually be converted to format_args.
-    template <std::size_t N>
+    ///
+    /// Up to 14 arguments are stored in eight-byte slots with their types
+    /// packed into a single 64-bit word.
+    template <typename... Args>
     struct format_arg_store;
 
+    /// A value passed to a format function under a name, which replacement
+    /// fields may refer to as {name} instead of by position.
+    ///
+    /// Create with arg. References the value, so it must only be used as a
+    /// temporary argument to a format function.
+    template <typename T>
+    struct named_arg;
+
+    /// Formats a string and arguments in pieces, each written into a
+    /// separate buffer and continuing exactly where the previous one
+    /// stopped, such as for a message that spans several fixed-size frames.
+    ///
+    /// Holds the format string and a format_arg_store of the arguments, so
+    /// anything those reference must outlive it. A replacement field that
+    /// is split between pieces is formatted again for the next piece,
+    /// dropping what was already written without writing padding, strings
+    /// or floating-point digits again, and stopping once the piece is full;
+    /// no earlier field or text is formatted again. As with format_sink, a
+    /// custom formatter that writes through pos directly continues exactly
+    /// only if it writes no more than 256 characters in any one write.
+    template <typename... Args>
+    struct format_cursor;
+
     /// Specialize to implement format support for a type.
     ///
     /// Two member functions must be defined:
@@ -51,6 +129,12 @@ namespace NANOFMT_NS {
     /// constexpr char const* parse(char const* in, char const* end) noexcept;
     ///
     /// void format(T const& value, format_output& out);
+    ///
+    /// A formatter may also define a measure member, which returns the length
+    /// that format would write, and is used instead of format for
+    /// format_length and once output is full:
+    ///
+    /// std::size_t measure(T const& value) const;
     template <typename T>
     struct formatter;
 
@@ -114,6 +198,42 @@ namespace NANOFMT_NS {
     template <std::size_t N>
     char* vformat_to(char (&dest)[N], format_string format_str, format_args args);
 
+    /// Result of the format_to_n_result and format_to_result functions.
+    struct format_result {
+        /// One past the last character written.
+        char* pos = nullptr;
+        /// Length of the untruncated output, _excluding_ any terminating
+        /// NUL; the output was truncated if this is larger than what was
+        /// written.
+        std::size_t size = 0;
+    };
+
+    /// Formats a string and arguments into dest, writing no more than count
+    /// bytes, like format_to_n. Also returns the length of the untruncated
+    /// output, so that a larger buffer can be sized for a retry without a
+    /// separate format_length pass.
+    template <typename... Args>
+    [[nodiscard]] format_result format_to_n_result(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        Args const&... args);
+
+    [[nodiscard]] inline format_result vformat_to_n_result(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        format_args args);
+
+    /// Formats a string and arguments into dest, like format_to, and also
+    /// returns the length of the untruncated output. The output will be
+    /// NUL-terminated.
+    template <std::size_t N, typename... Args>
+    format_result format_to_result(char (&dest)[N], format_string format_str, Args const&... args);
+
+    template <std::size_t N>
+    format_result vformat_to_result(char (&dest)[N], format_string format_str, format_args args);
+
     /// Returns the number of characters that would be written to a
     /// destination buffer (_excluding_ any terminating NUL) for the
     /// given format string and arguments
@@ -122,6 +242,24 @@ namespace NANOFMT_NS {
 
     [[nodiscard]] inline std::size_t vformat_length(format_string format_str, format_args args);
 
+    /// Formats a string and arguments into dest, writing no more than count
+    /// bytes, like format_to_n. Each replacement field selects its argument
+    /// by index rather than through format_args' type tags; custom
+    /// formatters are called directly and may be inlined, while builtin
+    /// types still call the library's formatters. Prefer format_to_n
+    /// except where the call is hot.
+    template <typename... Args>
+    [[nodiscard]] char* format_inline_to_n(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        Args const&... args);
+
+    /// Formats a string and arguments into dest, like format_to, with each
+    /// argument reached directly as for format_inline_to_n.
+    template <std::size_t N, typename... Args>
+    char* format_inline_to(char (&dest)[N], format_string format_str, Args const&... args);
+
     template <std::size_t N, typename... Args>
     [[nodiscard]] char* format_append_to(char* dest, std::size_t count, format_string format_str, Args const&... args);
 
@@ -143,6 +281,14 @@ namespace NANOFMT_NS {
     template <typename... Args>
     [[nodiscard]] constexpr auto make_format_args(Args const&... args) noexcept;
 
+    /// Names a format argument, so that replacement fields may refer to it
+    /// as {name}; the argument may also still be referred to by position.
+    ///
+    /// The name is hashed when the argument is created, which is folded at
+    /// compile time for a string literal.
+    template <std::size_t N, typename T>
+    [[nodiscard]] constexpr named_arg<T> arg(char const (&name)[N], T const& value) noexcept;
+
     // ----------------------
     //   Default Formatters
     // ----------------------
@@ -224,6 +370,19 @@ namespace NANOFMT_NS {
     struct formatter<void const*> : detail::default_formatter<void const*> {};
 } // namespace NANOFMT_NS
 
+/// Compiles a string literal into a nanofmt::compiled_format.
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+#    define NANOFMT_COMPILE(str) (::NANOFMT_NS::compile<str>)
+#else
+#    define NANOFMT_COMPILE(str)                                                                                       \
+        ([]() noexcept {                                                                                               \
+            struct nanofmt_compiled_source {                                                                           \
+                static constexpr ::NANOFMT_NS::format_string value() noexcept { return str; }                         \
+            };                                                                                                         \
+            return ::NANOFMT_NS::compiled_format<nanofmt_compiled_source>{};                                            \
+        }())
+#endif
+
 #include "format.inl"
 
 #endif // NANOFMT_FORMAT_H_
@@ -10,6 +10,69 @@ namespace NANOFMT_NS {
     namespace detail {
         format_output vformat(format_output out, format_string format_str, format_args args);
 
+        template <typename... Args>
+        format_output vformat_inline(format_output out, format_string format_str, Args const&... args);
+
+        // where a format_cursor resumes: either in a run of literal text, or
+        // at the { of a replacement field of which field_offset characters
+        // have been written; scan is where the search for the next { resumes
+        //
+        struct format_cursor_state {
+            char const* input = nullptr;
+            char const* scan = nullptr;
+            std::size_t field_offset = 0;
+            int arg_next_index = 0;
+            bool arg_auto_index = true;
+            bool at_field = false;
+            bool done = false;
+        };
+
+        char* vformat_cursor(
+            char* dest,
+            std::size_t count,
+            format_string format_str,
+            format_args const& args,
+            format_cursor_state& state);
+
+        char const* find_open_brace(char const* first, char const* last) noexcept;
+        void append_text(format_output& out, char const* text, std::size_t length) noexcept;
+
+        // parse a spec, if any, and format a value with its default formatter;
+        // one entry per format_arg value type, for vformat_inline
+        void format_builtin(int value, char const** in, char const* end, format_output& out);
+        void format_builtin(unsigned value, char const** in, char const* end, format_output& out);
+        void format_builtin(long value, char const** in, char const* end, format_output& out);
+        void format_builtin(unsigned long value, char const** in, char const* end, format_output& out);
+        void format_builtin(long long value, char const** in, char const* end, format_output& out);
+        void format_builtin(unsigned long long value, char const** in, char const* end, format_output& out);
+        void format_builtin(char value, char const** in, char const* end, format_output& out);
+#if NANOFMT_FLOAT
+        void format_builtin(float value, char const** in, char const* end, format_output& out);
+        void format_builtin(double value, char const** in, char const* end, format_output& out);
+#endif
+        void format_builtin(bool value, char const** in, char const* end, format_output& out);
+        void format_builtin(char const* value, char const** in, char const* end, format_output& out);
+        void format_builtin(void const* value, char const** in, char const* end, format_output& out);
+
+        struct format_segment;
+
+        // format a value with its default formatter and the spec of a field
+        // parsed ahead of time, for vformat_inline over prepared strings
+        void format_builtin(int value, format_segment const& field, format_output& out);
+        void format_builtin(unsigned value, format_segment const& field, format_output& out);
+        void format_builtin(long value, format_segment const& field, format_output& out);
+        void format_builtin(unsigned long value, format_segment const& field, format_output& out);
+        void format_builtin(long long value, format_segment const& field, format_output& out);
+        void format_builtin(unsigned long long value, format_segment const& field, format_output& out);
+        void format_builtin(char value, format_segment const& field, format_output& out);
+#if NANOFMT_FLOAT
+        void format_builtin(float value, format_segment const& field, format_output& out);
+        void format_builtin(double value, format_segment const& field, format_output& out);
+#endif
+        void format_builtin(bool value, format_segment const& field, format_output& out);
+        void format_builtin(char const* value, format_segment const& field, format_output& out);
+        void format_builtin(void const* value, format_segment const& field, format_output& out);
+
         // avoid explicitly pulling in <utility>
         template <typename T>
         const T& declval() noexcept;
@@ -29,8 +92,218 @@ namespace NANOFMT_NS {
             std::size_t max_length = 0;
         };
 
+        // a run of literal text from a format string, optionally followed by
+        // a replacement field whose spec has been parsed ahead of time
+        //
+        struct format_segment {
+            char const* text = nullptr;
+            std::size_t length = 0;
+
+            // -1 if no replacement field follows the text, or named_arg_index
+            // if the field refers to its argument by name
+            int arg_index = -1;
+
+            // the argument name of a named field, hashed ahead of time
+            char const* name = nullptr;
+            std::uint32_t name_length = 0;
+            std::uint32_t name_hash = 0;
+
+            // the spec text after the :, or nullptr if there is none; custom
+            // formatters still parse this when the argument is formatted
+            char const* spec = nullptr;
+            char const* spec_end = nullptr;
+
+            // the spec as parsed for any default formatter; the type is not
+            // yet checked against the types the argument's formatter allows
+            format_spec parsed;
+            bool explicit_align = false;
+
+            // true if the spec takes its width or precision from nested
+            // replacement fields, which are resolved when formatting;
+            // nested fields without an index count up from nested_arg_index
+            bool dynamic = false;
+            int nested_arg_index = 0;
+        };
+
+        // a custom formatter parsed from one replacement field of a prepared
+        // format string, reused by later calls that format the same type in
+        // that field; only small, trivially copyable formatters are stored
+        //
+        struct formatter_cache {
+            static constexpr std::size_t capacity = 56;
+
+            // identifies the formatter type held in storage, if any
+            void const* owner = nullptr;
+            unsigned char storage[capacity] = {};
+
+            // where a named field's argument was found among the named
+            // arguments of an earlier call, checked first on later calls
+            int named_slot = -1;
+        };
+
+        template <typename FormatterT>
+        inline constexpr char formatter_cache_id = 0;
+
+        template <typename FormatterT>
+        inline constexpr bool is_cacheable_formatter =
+            std::is_trivially_copyable_v<FormatterT> && sizeof(FormatterT) <= formatter_cache::capacity;
+
+        template <std::size_t N>
+        struct format_segment_list {
+            constexpr explicit format_segment_list(format_string format_str) noexcept;
+
+            format_segment items[N + 1 /* avoid size 0 */] = {};
+        };
+
+        // the segments of a compiled or prepared format string, which a
+        // format_string refers to with a single pointer
+        //
+        struct format_segment_data {
+            format_segment const* segments = nullptr;
+            std::size_t count = 0;
+
+            // parsed custom formatters, one per segment, for a prepared format
+            // string; nullptr if custom formatters must be parsed on every call
+            formatter_cache* caches = nullptr;
+        };
+
+        constexpr int parse_nonnegative(char const*& start, char const* end) noexcept;
+
+        // marks a format_segment whose field refers to its argument by name
+        inline constexpr int named_arg_index = -2;
+
+        // returns the end of the argument name at in, which is in itself if
+        // there is none; names are identifiers, as in C++
+        constexpr char const* parse_name(char const* in, char const* end) noexcept;
+
+        // 32-bit FNV-1a; names are only compared character by character once
+        // their hashes match
+        constexpr std::uint32_t hash_name(char const* first, char const* last) noexcept;
+
+        constexpr char const* find_spec_end(char const* in, char const* end, bool& nested) noexcept;
+
+        constexpr bool skip_nested_fields(
+            char const* spec,
+            char const* spec_end,
+            int& arg_next_index,
+            bool& arg_auto_index) noexcept;
+
+        // large enough for any spec whose nested fields are replaced by
+        // their values; longer specs are not formatted
+        inline constexpr std::size_t dynamic_spec_capacity = 64;
+
+        bool resolve_dynamic_spec(
+            char const* spec,
+            char const* spec_end,
+            format_args const& args,
+            int& arg_next_index,
+            bool& arg_auto_index,
+            char (&buffer)[dynamic_spec_capacity],
+            char const*& resolved_end) noexcept;
+
+        constexpr bool parse_spec_options(char const*& in, char const* end, format_spec& spec) noexcept;
+
+        constexpr char const* parse_spec(
+            char const* in,
+            char const* end,
+            format_spec& spec,
+            char const* allowed_types) noexcept;
+
+        constexpr std::size_t prepare_format(
+            format_string format_str,
+            format_segment* segments,
+            std::size_t capacity) noexcept;
+
+        using format_thunk =
+            void (*)(void const* value, char const** spec, char const* end, format_output& out, formatter_cache* cache);
+
+        // one eight-byte argument slot of a packed format_arg_store; custom
+        // arguments hold the address of the value, and their thunks are kept
+        // in extra slots after all arguments
+        //
+        union format_value {
+            constexpr format_value() noexcept : v_int(0) {}
+            constexpr format_value(int value) noexcept : v_int(value) {}
+            constexpr format_value(unsigned value) noexcept : v_unsigned(value) {}
+            constexpr format_value(long value) noexcept : v_long(value) {}
+            constexpr format_value(unsigned long value) noexcept : v_ulong(value) {}
+            constexpr format_value(long long value) noexcept : v_longlong(value) {}
+            constexpr format_value(unsigned long long value) noexcept : v_ulonglong(value) {}
+            constexpr format_value(char value) noexcept : v_char(value) {}
+            constexpr format_value(float value) noexcept : v_float(value) {}
+            constexpr format_value(double value) noexcept : v_double(value) {}
+            constexpr format_value(bool value) noexcept : v_bool(value) {}
+            constexpr format_value(char const* value) noexcept : v_cstring(value) {}
+            constexpr format_value(void const* value) noexcept : v_voidptr(value) {}
+            constexpr format_value(format_thunk thunk) noexcept : v_thunk(thunk) {}
+
+            int v_int;
+            unsigned v_unsigned;
+            long v_long;
+            unsigned long v_ulong;
+            long long v_longlong;
+            unsigned long long v_ulonglong;
+            char v_char;
+            float v_float;
+            double v_double;
+            bool v_bool;
+            char const* v_cstring;
+            void const* v_voidptr;
+            format_thunk v_thunk;
+        };
+
+        // up to max_packed_args arguments are described by one 64-bit word,
+        // with four bits of format_arg::type per argument and the count in
+        // the top four bits; larger lists store each format_arg whole, and
+        // mark the top four bits with unpacked_args
+        //
+        inline constexpr std::size_t max_packed_args = 14;
+        inline constexpr int packed_type_bits = 4;
+        inline constexpr int packed_count_shift = 60;
+        inline constexpr std::uint64_t unpacked_args = 0xF;
+
+        // named arguments are described by two slots after any thunks: the
+        // name, then its hash, length and argument index from pack_name_info;
+        // their count is kept in the four bits below the packed count, or
+        // above the 32-bit count of an unpacked list
+        //
+        inline constexpr int packed_named_shift = 56;
+        inline constexpr int unpacked_named_shift = 32;
+
+        constexpr unsigned long long pack_name_info(
+            std::uint32_t hash,
+            std::uint32_t length,
+            std::size_t index) noexcept {
+            return hash | (static_cast<unsigned long long>(length & 0xFFFF) << 32) |
+                (static_cast<unsigned long long>(index & 0xFFFF) << 48);
+        }
+
+        template <typename ValueT>
+        struct is_custom_format_arg;
+
+        template <typename T>
+        struct is_named_arg : std::false_type {};
+        template <typename T>
+        struct is_named_arg<named_arg<T>> : std::true_type {};
+
+        template <typename T>
+        constexpr T const& unwrap_named_arg(T const& value) noexcept {
+            return value;
+        }
+        template <typename T>
+        constexpr T const& unwrap_named_arg(named_arg<T> const& arg) noexcept {
+            return arg.value;
+        }
     } // namespace detail
 
+    template <typename T>
+    struct named_arg {
+        char const* name = nullptr;
+        std::uint32_t length = 0;
+        std::uint32_t hash = 0;
+        T const& value;
+    };
+
     struct format_arg {
         enum class type {
             t_mono,
@@ -50,7 +323,7 @@ namespace NANOFMT_NS {
         };
 
         struct custom {
-            void (*thunk)(void const* value, char const** spec, char const* end, format_output& out) = nullptr;
+            detail::format_thunk thunk = nullptr;
             void const* value = nullptr;
         };
 
@@ -88,26 +361,50 @@ namespace NANOFMT_NS {
         type tag = type::t_mono;
     };
 
-    template <size_t N>
+    template <typename... Args>
     struct format_arg_store {
-        static constexpr size_t size = N;
-        format_arg values[N + 1 /* avoid size 0 */];
+        static constexpr size_t size = sizeof...(Args);
+        static constexpr bool packed = size <= detail::max_packed_args;
+        static constexpr size_t custom_count = (size_t{0} + ... + size_t{detail::is_custom_format_arg<Args>::value});
+        static constexpr size_t named_count = (size_t{0} + ... + size_t{detail::is_named_arg<Args>::value});
+        static constexpr size_t names_index = packed ? size + custom_count : size;
+
+        constexpr explicit format_arg_store(Args const&... args) noexcept;
+
+        constexpr void pack(format_arg const& arg, std::size_t index, std::size_t& thunk_index) noexcept;
+
+        template <typename ValueT>
+        constexpr void add_name(ValueT const& arg, std::size_t index, std::size_t& name_index) noexcept;
+
+        std::uint64_t types = 0;
+        std::conditional_t<packed, detail::format_value, format_arg>
+            values[names_index + 2 * named_count + 1 /* avoid size 0 */];
     };
 
     struct format_args {
-        template <size_t N>
-        constexpr /*implicit*/ format_args(format_arg_store<N>&& values) noexcept : values(values.values)
-                                                                                  , count(N) {}
+        template <typename... Args>
+        constexpr /*implicit*/ format_args(format_arg_store<Args...>&& store) noexcept;
+
+        constexpr format_arg get(unsigned index) const noexcept;
+
+        // returns the index of the argument with the given name, or -1 if
+        // there is none; slot, if given, is the position among the named
+        // arguments to check first, and is updated to where the name is found
+        int find(char const* name, std::uint32_t length, std::uint32_t hash, int* slot = nullptr) const noexcept;
 
         void format(unsigned index, char const** in, char const* end, format_output& out) const;
+        void format(detail::format_segment const& field, detail::formatter_cache* cache, format_output& out) const;
 
-        format_arg const* values = nullptr;
-        size_t count = 0;
+        std::uint64_t types = 0;
+        union {
+            detail::format_value const* values = nullptr;
+            format_arg const* args;
+        };
     };
 
     template <typename... Args>
     [[nodiscard]] constexpr auto make_format_args(Args const&... args) noexcept {
-        return format_arg_store<sizeof...(Args)>{detail::make_format_arg(args)...};
+        return format_arg_store<Args...>{args...};
     }
 
     struct format_string {
@@ -122,6 +419,111 @@ namespace NANOFMT_NS {
 
         char const* begin = nullptr;
         char const* end = nullptr;
+
+        // literal text and replacement fields split out ahead of time, for a
+        // compiled or prepared format string; formatting then skips scanning
+        // the string
+        detail::format_segment_data const* prepared = nullptr;
+    };
+
+    template <typename SourceT>
+    struct compiled_format {
+        static constexpr format_string source = SourceT::value();
+        static constexpr std::size_t segment_count = detail::prepare_format(source, nullptr, 0);
+        static constexpr detail::format_segment_list<segment_count> segments{source};
+        static constexpr detail::format_segment_data data{segments.items, segment_count};
+    };
+
+    template <std::size_t MaxSegments>
+    struct prepared_format {
+        constexpr explicit prepared_format(format_string format_str) noexcept;
+
+        // a copy refers to its own segments, and starts with no parsed
+        // custom formatters
+        constexpr prepared_format(prepared_format const& other) noexcept;
+        constexpr prepared_format& operator=(prepared_format const& other) noexcept;
+
+        /// True if the string fit in MaxSegments and formats from the
+        /// prepared segments.
+        constexpr bool prepared() const noexcept { return segment_count <= MaxSegments; }
+
+        format_string source;
+        std::size_t segment_count = 0;
+        detail::format_segment segments[MaxSegments] = {};
+        mutable detail::formatter_cache caches[MaxSegments] = {};
+        detail::format_segment_data data;
+    };
+
+    template <typename... Args>
+    struct format_cursor {
+        constexpr explicit format_cursor(format_string format_str, Args const&... args) noexcept
+            : source(format_str)
+            , store(args...) {}
+
+        /// Writes the next piece of output into dest, writing no more than
+        /// count bytes. The destination will **NOT** be NUL-terminated.
+        /// Returns a pointer past the last character written; only a piece
+        /// that reaches the end of the output may be shorter than count.
+        [[nodiscard]] char* format_to_n(char* dest, std::size_t count);
+
+        /// True once all output has been written.
+        constexpr bool done() const noexcept { return state.done; }
+
+        format_string source;
+        format_arg_store<Args...> store;
+        detail::format_cursor_state state;
+    };
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+    namespace detail {
+        template <std::size_t N>
+        struct fixed_string {
+            constexpr /*implicit*/ fixed_string(char const (&str)[N]) noexcept {
+                for (std::size_t index = 0; index != N; ++index) {
+                    chars[index] = str[index];
+                }
+            }
+
+            char chars[N] = {};
+        };
+
+        template <fixed_string Str>
+        struct fixed_string_source {
+            static constexpr format_string value() noexcept { return format_string{Str.chars}; }
+        };
+    } // namespace detail
+
+    template <detail::fixed_string Str>
+    inline constexpr compiled_format<detail::fixed_string_source<Str>> compile{};
+#endif
+
+    struct format_sink {
+        using flush_callback = void (*)(void* context, char const* data, std::size_t length);
+
+        constexpr format_sink(
+            char* buffer,
+            std::size_t buffer_size,
+            flush_callback flush_fn,
+            void* user_context = nullptr) noexcept
+            : chunk(buffer)
+            , capacity(buffer_size)
+            , callback(flush_fn)
+            , context(user_context) {}
+        template <std::size_t N>
+        constexpr format_sink(char (&buffer)[N], flush_callback flush_fn, void* user_context = nullptr) noexcept
+            : format_sink(buffer, N, flush_fn, user_context) {}
+
+        /// An output that writes into the chunk, starting from its beginning.
+        constexpr format_output output() noexcept;
+
+        char* chunk = nullptr;
+        std::size_t capacity = 0; // must not be zero
+        flush_callback callback = nullptr;
+        void* context = nullptr;
+
+        // characters to drop from the start of the output before any reach
+        // the callback; padding and strings are dropped without being written
+        std::size_t discard = 0;
     };
 
     struct format_output {
@@ -129,6 +531,10 @@ namespace NANOFMT_NS {
         char const* end = nullptr;
         std::size_t advance = 0;
 
+        // when set, pos and end are within the sink's chunk, and the chunk is
+        // flushed rather than output being truncated
+        format_sink* sink = nullptr;
+
         constexpr format_output& append(char const* zstr) noexcept;
         constexpr format_output& append(char const* source, std::size_t length) noexcept;
 
@@ -142,6 +548,15 @@ namespace NANOFMT_NS {
         inline format_output& vformat(format_string fmt, format_args args);
 
         constexpr format_output& advance_to(char* p) noexcept;
+
+        // true when nothing more can be written, as for format_length or a
+        // full buffer; formatters then need only add their length to advance
+        constexpr bool full() const noexcept;
+
+        // passes everything written to the chunk so far to the sink's
+        // callback, and starts again from the beginning of the chunk; does
+        // nothing if there is no sink
+        constexpr format_output& flush() noexcept;
     };
 
     constexpr char* copy_to(char* dest, char const* end, char const* source) noexcept {
@@ -171,6 +586,12 @@ namespace NANOFMT_NS {
         char const pad_buffer[] = {ch, ch, ch, ch, ch, ch, ch, ch};
         constexpr std::size_t pad_length = sizeof pad_buffer;
 
+        // padding that would not fit costs nothing, however wide it is
+        auto const available = static_cast<std::size_t>(end - dest);
+        if (count > available) {
+            count = available;
+        }
+
         while (count >= pad_length) {
             dest = copy_to_n(dest, end, pad_buffer, pad_length);
             count -= pad_length;
@@ -186,9 +607,48 @@ namespace NANOFMT_NS {
         return count;
     }
 
+    constexpr format_output format_sink::output() noexcept {
+        return {chunk, chunk + capacity, 0, this};
+    }
+
+    namespace detail {
+        // drops up to length characters that a sink is still to discard, if
+        // nothing is waiting in its chunk to be discarded first; returns the
+        // number of characters dropped
+        //
+        constexpr std::size_t discard_output(format_output& out, std::size_t length) noexcept {
+            format_sink* const sink = out.sink;
+            if (sink->discard == 0 || out.pos != sink->chunk) {
+                return 0;
+            }
+            std::size_t const dropped = length < sink->discard ? length : sink->discard;
+            sink->discard -= dropped;
+            return dropped;
+        }
+    } // namespace detail
+
+    // with a sink, each write that fills the chunk flushes it and carries on
+    // from the beginning of the chunk, until everything is written
+    //
     constexpr format_output& format_output::append(char const* const zstr) noexcept {
-        char* const p = copy_to(pos, end, zstr);
-        std::size_t const consumed = p - pos;
+        if (sink != nullptr && sink->discard != 0) {
+            return append(zstr, __builtin_strlen(zstr));
+        }
+
+        char* p = copy_to(pos, end, zstr);
+        std::size_t consumed = p - pos;
+        if (sink != nullptr) {
+            while (zstr[consumed] != '\0') {
+                pos = p;
+                flush();
+                if (sink == nullptr) {
+                    p = pos;
+                    break;
+                }
+                p = copy_to(pos, end, zstr + consumed);
+                consumed += p - pos;
+            }
+        }
         pos = p;
         advance += consumed;
         advance += __builtin_strlen(zstr + consumed);
@@ -196,20 +656,88 @@ namespace NANOFMT_NS {
     }
 
     constexpr format_output& format_output::append(char const* source, std::size_t length) noexcept {
-        pos = copy_to_n(pos, end, source, length);
         advance += length;
+        if (sink != nullptr) {
+            std::size_t const dropped = detail::discard_output(*this, length);
+            source += dropped;
+            length -= dropped;
+        }
+
+        char* p = copy_to_n(pos, end, source, length);
+        if (sink != nullptr) {
+            for (std::size_t consumed = p - pos; consumed != length; consumed += p - pos) {
+                pos = p;
+                flush();
+                if (sink == nullptr) {
+                    return *this;
+                }
+                p = copy_to_n(pos, end, source + consumed, length - consumed);
+            }
+        }
+        pos = p;
         return *this;
     }
 
     constexpr format_output& format_output::put(char ch) noexcept {
-        pos = ::NANOFMT_NS::put(pos, end, ch);
         ++advance;
+        if (sink != nullptr && detail::discard_output(*this, 1) != 0) {
+            return *this;
+        }
+
+        if (pos == end && sink != nullptr) {
+            flush();
+        }
+        pos = ::NANOFMT_NS::put(pos, end, ch);
         return *this;
     }
 
     constexpr format_output& format_output::fill_n(char ch, std::size_t count) noexcept {
-        pos = ::NANOFMT_NS::fill_n(pos, end, ch, count);
         advance += count;
+        if (sink != nullptr) {
+            count -= detail::discard_output(*this, count);
+        }
+
+        char* p = ::NANOFMT_NS::fill_n(pos, end, ch, count);
+        if (sink != nullptr) {
+            for (std::size_t consumed = p - pos; consumed != count; consumed += p - pos) {
+                pos = p;
+                flush();
+                if (sink == nullptr) {
+                    return *this;
+                }
+                p = ::NANOFMT_NS::fill_n(pos, end, ch, count - consumed);
+            }
+        }
+        pos = p;
+        return *this;
+    }
+
+    constexpr bool format_output::full() const noexcept {
+        return pos == end && sink == nullptr;
+    }
+
+    constexpr format_output& format_output::flush() noexcept {
+        if (sink != nullptr && pos != sink->chunk) {
+            // what is still to be discarded was written directly, and so is
+            // at the front of the chunk
+            auto const length = static_cast<std::size_t>(pos - sink->chunk);
+            std::size_t const dropped = length < sink->discard ? length : sink->discard;
+            sink->discard -= dropped;
+            if (dropped != length) {
+                sink->callback(sink->context, sink->chunk + dropped, length - dropped);
+            }
+
+            // a callback that clears the chunk ends the output, and what is
+            // formatted after that is only counted toward advance
+            if (sink->chunk == nullptr) {
+                pos = nullptr;
+                end = nullptr;
+                sink = nullptr;
+                return *this;
+            }
+            pos = sink->chunk;
+            end = sink->chunk + sink->capacity;
+        }
         return *this;
     }
 
@@ -226,6 +754,9 @@ namespace NANOFMT_NS {
         size_t const diff = p - pos;
         pos = p;
         advance += diff;
+        if (pos == end && sink != nullptr) {
+            flush();
+        }
         return *this;
     }
 
@@ -255,6 +786,220 @@ namespace NANOFMT_NS {
         return {value.data(), value.size()};
     }
 
+    template <std::size_t MaxSegments>
+    constexpr prepared_format<MaxSegments>::prepared_format(format_string format_str) noexcept
+        : source(format_str)
+        , data{segments, 0, caches} {
+        source.prepared = nullptr;
+        segment_count = detail::prepare_format(source, segments, MaxSegments);
+        data.count = segment_count;
+    }
+
+    template <std::size_t MaxSegments>
+    constexpr prepared_format<MaxSegments>::prepared_format(prepared_format const& other) noexcept
+        : prepared_format(other.source) {}
+
+    template <std::size_t MaxSegments>
+    constexpr prepared_format<MaxSegments>& prepared_format<MaxSegments>::operator=(
+        prepared_format const& other) noexcept {
+        source = other.source;
+        segment_count = other.segment_count;
+        for (std::size_t index = 0; index != MaxSegments; ++index) {
+            segments[index] = other.segments[index];
+            caches[index] = detail::formatter_cache{};
+        }
+        data.count = segment_count;
+        return *this;
+    }
+
+    template <std::size_t MaxSegments>
+    constexpr format_string to_format_string(prepared_format<MaxSegments> const& prepared) noexcept {
+        format_string result = prepared.source;
+        if (prepared.prepared()) {
+            result.prepared = &prepared.data;
+        }
+        return result;
+    }
+
+    template <typename SourceT>
+    constexpr format_string to_format_string(compiled_format<SourceT> const&) noexcept {
+        using compiled_t = compiled_format<SourceT>;
+
+        format_string result = compiled_t::source;
+        result.prepared = &compiled_t::data;
+        return result;
+    }
+
+    template <typename... Args>
+    constexpr format_arg_store<Args...>::format_arg_store(Args const&... args) noexcept {
+        // expanded per argument rather than looped, so that the types and
+        // each value's slot are resolved at compile time
+        std::size_t index = 0;
+        if constexpr (packed) {
+            types = (std::uint64_t{size} << detail::packed_count_shift) |
+                (std::uint64_t{named_count} << detail::packed_named_shift);
+            std::size_t thunk_index = size;
+            (pack(detail::make_format_arg(detail::unwrap_named_arg(args)), index++, thunk_index), ...);
+        }
+        else {
+            types = (detail::unpacked_args << detail::packed_count_shift) |
+                (std::uint64_t{named_count} << detail::unpacked_named_shift) | size;
+            ((values[index++] = detail::make_format_arg(detail::unwrap_named_arg(args))), ...);
+        }
+
+        if constexpr (named_count != 0) {
+            index = 0;
+            std::size_t name_index = names_index;
+            (add_name(args, index++, name_index), ...);
+        }
+    }
+
+    template <typename... Args>
+    constexpr void format_arg_store<Args...>::pack(
+        format_arg const& arg,
+        std::size_t index,
+        std::size_t& thunk_index) noexcept {
+        types |= static_cast<std::uint64_t>(arg.tag) << (index * detail::packed_type_bits);
+
+        switch (arg.tag) {
+            case format_arg::type::t_int:
+                values[index] = arg.v_int;
+                break;
+            case format_arg::type::t_uint:
+                values[index] = arg.v_unsigned;
+                break;
+            case format_arg::type::t_long:
+                values[index] = arg.v_long;
+                break;
+            case format_arg::type::t_ulong:
+                values[index] = arg.v_ulong;
+                break;
+            case format_arg::type::t_longlong:
+                values[index] = arg.v_longlong;
+                break;
+            case format_arg::type::t_ulonglong:
+                values[index] = arg.v_ulonglong;
+                break;
+            case format_arg::type::t_char:
+                values[index] = arg.v_char;
+                break;
+            case format_arg::type::t_float:
+                values[index] = arg.v_float;
+                break;
+            case format_arg::type::t_double:
+                values[index] = arg.v_double;
+                break;
+            case format_arg::type::t_bool:
+                values[index] = arg.v_bool;
+                break;
+            case format_arg::type::t_cstring:
+                values[index] = arg.v_cstring;
+                break;
+            case format_arg::type::t_voidptr:
+                values[index] = arg.v_voidptr;
+                break;
+            case format_arg::type::t_custom:
+                values[index] = arg.v_custom.value;
+                values[thunk_index++] = arg.v_custom.thunk;
+                break;
+            default:
+                break;
+        }
+    }
+
+    template <typename... Args>
+    template <typename ValueT>
+    constexpr void format_arg_store<Args...>::add_name(
+        ValueT const& arg,
+        std::size_t index,
+        std::size_t& name_index) noexcept {
+        if constexpr (detail::is_named_arg<ValueT>::value) {
+            values[name_index++] = arg.name;
+            values[name_index++] = detail::pack_name_info(arg.hash, arg.length, index);
+        }
+    }
+
+    template <typename... Args>
+    constexpr format_args::format_args(format_arg_store<Args...>&& store) noexcept : types(store.types) {
+        if constexpr (format_arg_store<Args...>::packed) {
+            values = store.values;
+        }
+        else {
+            args = store.values;
+        }
+    }
+
+    constexpr format_arg format_args::get(unsigned index) const noexcept {
+        using types_t = format_arg::type;
+
+        std::uint64_t const count = types >> detail::packed_count_shift;
+        if (count == detail::unpacked_args) {
+            auto const unpacked_count = static_cast<std::uint32_t>(types);
+            return index < unpacked_count ? args[index] : format_arg{};
+        }
+        if (index >= count) {
+            return {};
+        }
+
+        constexpr std::uint64_t type_mask = (std::uint64_t{1} << detail::packed_type_bits) - 1;
+        detail::format_value const& value = values[index];
+        switch (static_cast<types_t>((types >> (index * detail::packed_type_bits)) & type_mask)) {
+            case types_t::t_int:
+                return value.v_int;
+            case types_t::t_uint:
+                return value.v_unsigned;
+            case types_t::t_long:
+                return value.v_long;
+            case types_t::t_ulong:
+                return value.v_ulong;
+            case types_t::t_longlong:
+                return value.v_longlong;
+            case types_t::t_ulonglong:
+                return value.v_ulonglong;
+            case types_t::t_char:
+                return value.v_char;
+            case types_t::t_float:
+                return value.v_float;
+            case types_t::t_double:
+                return value.v_double;
+            case types_t::t_bool:
+                return value.v_bool;
+            case types_t::t_cstring:
+                return value.v_cstring;
+            case types_t::t_voidptr:
+                return value.v_voidptr;
+            case types_t::t_custom: {
+                // thunks are stored in argument order after the last argument
+                std::size_t thunk_index = count;
+                for (unsigned prior = 0; prior != index; ++prior) {
+                    if (((types >> (prior * detail::packed_type_bits)) & type_mask) ==
+                        static_cast<std::uint64_t>(types_t::t_custom)) {
+                        ++thunk_index;
+                    }
+                }
+
+                format_arg::custom custom;
+                custom.thunk = values[thunk_index].v_thunk;
+                custom.value = value.v_voidptr;
+                return custom;
+            }
+            default:
+                return {};
+        }
+    }
+
+    template <std::size_t N, typename T>
+    constexpr named_arg<T> arg(char const (&name)[N], T const& value) noexcept {
+        auto const length = static_cast<std::uint32_t>(__builtin_strlen(name));
+        return {name, length, detail::hash_name(name, name + length), value};
+    }
+
+    template <typename... Args>
+    char* format_cursor<Args...>::format_to_n(char* dest, std::size_t count) {
+        format_args const args(static_cast<format_arg_store<Args...>&&>(store));
+        return detail::vformat_cursor(dest, count, source, args, state);
+    }
+
     [[nodiscard]] char* vformat_to_n(char* dest, std::size_t count, format_string format_str, format_args args) {
         return detail::vformat(format_output{dest, dest + count}, format_str, static_cast<format_args&&>(args)).pos;
     }
@@ -324,16 +1069,434 @@ namespace NANOFMT_NS {
         return pos;
     }
 
+    template <typename... Args>
+    [[nodiscard]] format_result format_to_n_result(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        Args const&... args) {
+        format_output const out =
+            detail::vformat(format_output{dest, dest + count}, format_str, ::NANOFMT_NS::make_format_args(args...));
+        return {out.pos, out.advance};
+    }
+
+    [[nodiscard]] format_result vformat_to_n_result(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        format_args args) {
+        format_output const out =
+            detail::vformat(format_output{dest, dest + count}, format_str, static_cast<format_args&&>(args));
+        return {out.pos, out.advance};
+    }
+
+    template <std::size_t N, typename... Args>
+    format_result format_to_result(char (&dest)[N], format_string format_str, Args const&... args) {
+        return ::NANOFMT_NS::vformat_to_result(dest, format_str, ::NANOFMT_NS::make_format_args(args...));
+    }
+
+    template <std::size_t N>
+    format_result vformat_to_result(char (&dest)[N], format_string format_str, format_args args) {
+        format_output const out = detail::vformat(format_output{dest, dest + (N - 1 /*NUL*/)}, format_str, args);
+        *out.pos = '\0';
+        return {out.pos, out.advance};
+    }
+
     template <typename... Args>
     [[nodiscard]] std::size_t format_length(format_string format_str, Args const&... args) {
         return detail::vformat(format_output{}, format_str, ::NANOFMT_NS::make_format_args(args...)).advance;
     }
 
+    template <typename... Args>
+    [[nodiscard]] char* format_inline_to_n(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        Args const&... args) {
+        return detail::vformat_inline(format_output{dest, dest + count}, format_str, args...).pos;
+    }
+
+    template <std::size_t N, typename... Args>
+    char* format_inline_to(char (&dest)[N], format_string format_str, Args const&... args) {
+        char* const pos = detail::vformat_inline(format_output{dest, dest + (N - 1 /*NUL*/)}, format_str, args...).pos;
+        *pos = '\0';
+        return pos;
+    }
+
     [[nodiscard]] std::size_t vformat_length(format_string format_str, format_args args) {
         return detail::vformat(format_output{}, format_str, static_cast<format_args&&>(args)).advance;
     }
 
     namespace detail {
+        constexpr int parse_nonnegative(char const*& start, char const* end) noexcept {
+            if (start == end) {
+                return -1;
+            }
+
+            if (*start == '0') {
+                ++start;
+                return 0;
+            }
+
+            // there must be at least one non-zero digit
+            if (!(*start >= '1' && *start <= '9')) {
+                return -1;
+            }
+
+            int result = 0;
+            while (start != end && *start >= '0' && *start <= '9') {
+                result *= 10;
+                result += *start - '0';
+                ++start;
+            }
+            return result;
+        }
+
+        constexpr char const* parse_name(char const* in, char const* end) noexcept {
+            auto const is_name_char = [](char c, bool first) noexcept {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+                    (!first && c >= '0' && c <= '9');
+            };
+
+            if (in == end || !is_name_char(*in, true)) {
+                return in;
+            }
+            ++in;
+            while (in != end && is_name_char(*in, false)) {
+                ++in;
+            }
+            return in;
+        }
+
+        constexpr std::uint32_t hash_name(char const* first, char const* last) noexcept {
+            std::uint32_t hash = 2166136261u;
+            for (; first != last; ++first) {
+                hash ^= static_cast<unsigned char>(*first);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        // finds the } that closes a replacement field's spec, stepping over
+        // any nested {} fields for the width or precision
+        //
+        constexpr char const* find_spec_end(char const* in, char const* end, bool& nested) noexcept {
+            int depth = 0;
+            for (; in != end; ++in) {
+                if (*in == '{') {
+                    nested = true;
+                    ++depth;
+                }
+                else if (*in == '}') {
+                    if (depth == 0) {
+                        break;
+                    }
+                    --depth;
+                }
+            }
+            return in;
+        }
+
+        // takes the automatic indices of a spec's nested fields, which come
+        // after the field's own, whether or not the field is formatted; an
+        // explicit nested index disables automatic indices as for any other
+        // field; returns false if a nested field cannot be resolved
+        //
+        constexpr bool skip_nested_fields(
+            char const* spec,
+            char const* spec_end,
+            int& arg_next_index,
+            bool& arg_auto_index) noexcept {
+            for (char const* nested = spec; nested != spec_end; ++nested) {
+                if (*nested != '{') {
+                    continue;
+                }
+                ++nested;
+                if (parse_nonnegative(nested, spec_end) != -1) {
+                    arg_auto_index = false;
+                }
+                else if (char const* const name_end = parse_name(nested, spec_end); name_end != nested) {
+                    nested = name_end;
+                }
+                else if (arg_auto_index) {
+                    ++arg_next_index;
+                }
+                else {
+                    return false;
+                }
+                if (nested == spec_end) {
+                    break;
+                }
+            }
+            return true;
+        }
+
+        // parses everything in a spec that precedes the presentation type;
+        // returns false if the spec ended, or is malformed, before the type
+        //
+        constexpr bool parse_spec_options(char const*& in, char const* end, format_spec& spec) noexcept {
+            if (in == end) {
+                return false;
+            }
+
+            auto const is_align = [](char const* c, char const* e) noexcept {
+                return c != e && (*c == '<' || *c == '>' || *c == '^');
+            };
+
+            // -- parse fill -
+            //
+            if (*in != '{' && *in != '}' && is_align(in + 1, end)) {
+                spec.fill = *in;
+                ++in;
+
+                if (in == end) {
+                    return false;
+                }
+            }
+
+            // -- parse alignment --
+            //
+            switch (*in) {
+                case '<':
+                    spec.align = -1;
+                    ++in;
+                    break;
+                case '>':
+                    spec.align = +1;
+                    ++in;
+                    break;
+                case '^':
+                    spec.align = 0;
+                    ++in;
+                    break;
+                default:
+                    break;
+            }
+            if (in == end) {
+                return false;
+            }
+
+            // -- parse sign --
+            //
+            switch (*in) {
+                case '+':
+                case '-':
+                case ' ':
+                    spec.sign = *in++;
+                    if (in == end) {
+                        return false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            // -- parse alternate form flag --
+            //
+            if (*in == '#') {
+                spec.alt_form = true;
+                ++in;
+                if (in == end) {
+                    return false;
+                }
+            }
+
+            // -- parse zero pad flag --
+            //
+            if (*in == '0') {
+                spec.zero_pad = true;
+                ++in;
+                if (in == end) {
+                    return false;
+                }
+            }
+
+            // -- parse width
+            //
+            if (int const width = parse_nonnegative(in, end); width >= 0) {
+                spec.width = width;
+                if (in == end) {
+                    return false;
+                }
+
+                // a width of 0 is not allowed
+                if (width == 0) {
+                    --in;
+                    return false;
+                }
+            }
+
+            // -- parse precision
+            //
+            if (*in == '.') {
+                ++in;
+                int const precision = parse_nonnegative(in, end);
+                if (precision < 0) {
+                    return false;
+                }
+
+                spec.precision = precision;
+                if (in == end) {
+                    return false;
+                }
+            }
+
+            // -- parse locale flag (ignored)
+            //
+            if (*in == 'L') {
+                ++in;
+                if (in == end) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        constexpr char const* parse_spec(
+            char const* in,
+            char const* end,
+            format_spec& spec,
+            char const* allowed_types) noexcept {
+            // -- parse type
+            //
+            if (parse_spec_options(in, end, spec) && allowed_types != nullptr) {
+                for (char const* t = allowed_types; *t != 0; ++t) {
+                    if (*in == *t) {
+                        spec.type = *in++;
+                        break;
+                    }
+                }
+            }
+            return in;
+        }
+
+        // splits a format string into segments the same way vformat scans it,
+        // writing up to capacity segments; returns the number of segments
+        // needed for the whole string
+        //
+        // a replacement field always extends to the next }, so text that a
+        // malformed spec leaves unparsed is dropped rather than written out
+        //
+        constexpr std::size_t prepare_format(
+            format_string format_str,
+            format_segment* segments,
+            std::size_t capacity) noexcept {
+            std::size_t count = 0;
+            auto const emit = [&count, segments, capacity](format_segment const& segment) noexcept {
+                if (count < capacity) {
+                    segments[count] = segment;
+                }
+                ++count;
+            };
+
+            int arg_next_index = 0;
+            bool arg_auto_index = true;
+
+            char const* input = format_str.begin;
+            char const* input_begin = input;
+            char const* const input_end = format_str.end;
+
+            while (input != input_end) {
+                if (*input != '{') {
+                    ++input;
+                    continue;
+                }
+
+                format_segment segment;
+                segment.text = input_begin;
+                segment.length = static_cast<std::size_t>(input - input_begin);
+
+                ++input; // swallow the {
+
+                // an incomplete format at the end of the string ends formatting
+                if (input == input_end) {
+                    emit(segment);
+                    return count;
+                }
+
+                // a {{ escape is a literal {, which begins the next text run
+                if (*input == '{') {
+                    emit(segment);
+                    input_begin = input++;
+                    continue;
+                }
+
+                // a named field leaves automatic indexing as it was
+                if (segment.arg_index = parse_nonnegative(input, input_end); segment.arg_index != -1) {
+                    arg_auto_index = false;
+                }
+                else if (char const* const name_end = parse_name(input, input_end); name_end != input) {
+                    segment.arg_index = named_arg_index;
+                    segment.name = input;
+                    segment.name_length = static_cast<std::uint32_t>(name_end - input);
+                    segment.name_hash = hash_name(input, name_end);
+                    input = name_end;
+                }
+                else if (arg_auto_index) {
+                    segment.arg_index = arg_next_index++;
+                }
+                else {
+                    // a non-explicit index after an explicit index ends formatting
+                    emit(segment);
+                    return count;
+                }
+
+                if (input != input_end && *input == ':') {
+                    segment.spec = ++input;
+
+                    // integers are right-aligned unless the spec says otherwise
+                    if (input != input_end) {
+                        bool const filled = *input != '{' && *input != '}' && input + 1 != input_end &&
+                            (input[1] == '<' || input[1] == '>' || input[1] == '^');
+                        char const align = filled ? input[1] : *input;
+                        segment.explicit_align = align == '<' || align == '>' || align == '^';
+                    }
+
+                    char const* options_end = input;
+                    if (parse_spec_options(options_end, input_end, segment.parsed)) {
+                        segment.parsed.type = *options_end;
+                    }
+
+                    input = find_spec_end(input, input_end, segment.dynamic);
+                }
+
+                // a non-explicit nested index after an explicit index cannot
+                // be resolved, so the field writes nothing, as in vformat
+                if (segment.dynamic) {
+                    segment.nested_arg_index = arg_next_index;
+                    if (!skip_nested_fields(segment.spec, input, arg_next_index, arg_auto_index)) {
+                        segment.arg_index = -1;
+                        segment.dynamic = false;
+                    }
+                }
+
+                while (input != input_end && *input != '}') {
+                    ++input;
+                }
+                segment.spec_end = input;
+                if (input != input_end) {
+                    ++input;
+                }
+
+                emit(segment);
+                input_begin = input;
+            }
+
+            if (input_begin != input_end) {
+                format_segment segment;
+                segment.text = input_begin;
+                segment.length = static_cast<std::size_t>(input_end - input_begin);
+                emit(segment);
+            }
+            return count;
+        }
+
+        template <std::size_t N>
+        constexpr format_segment_list<N>::format_segment_list(format_string format_str) noexcept {
+            prepare_format(format_str, items, N);
+        }
+
         template <typename T>
         using has_formatter = std::is_default_constructible<::NANOFMT_NS::formatter<T>>;
 
@@ -365,6 +1528,104 @@ namespace NANOFMT_NS {
             using type = void const*;
         };
 
+        // true if FormatterT has a measure member, which returns the length
+        // that format would write for a value without writing anything
+        //
+        template <typename FormatterT, typename ValueT, typename = void>
+        struct has_measure : std::false_type {};
+        template <typename FormatterT, typename ValueT>
+        struct has_measure<
+            FormatterT,
+            ValueT,
+            std::void_t<decltype(declval<FormatterT>().measure(declval<ValueT>()))>> : std::true_type {};
+
+        // a custom formatter writing to a sink is given a chunk of its own, so
+        // that it can write up to this many characters through pos directly
+        // however much of the sink's chunk is already used
+        //
+        inline constexpr std::size_t custom_chunk_size = 256;
+
+        // the output that a custom formatter's own chunk is passed on to
+        //
+        struct custom_output {
+            format_output* out = nullptr;
+            format_sink* sink = nullptr;
+        };
+
+        void forward_custom_output(void* context, char const* data, std::size_t length) noexcept;
+
+        // formats value with a custom formatter, or only measures it when the
+        // output is full and the formatter can do so
+        //
+        template <typename FormatterT, typename ValueT>
+        void format_custom_value(FormatterT& fmt, ValueT const& value, format_output& out) {
+            if constexpr (has_measure<FormatterT, ValueT>::value) {
+                if (out.full()) {
+                    out.advance += fmt.measure(value);
+                    return;
+                }
+            }
+            if (out.sink != nullptr) {
+                char chunk[custom_chunk_size];
+                format_sink sink(chunk, &forward_custom_output);
+                custom_output forward{&out, &sink};
+                sink.context = &forward;
+
+                std::size_t const advance = out.advance;
+                format_output custom_out = sink.output();
+                fmt.format(value, custom_out);
+                custom_out.flush();
+                out.advance = advance + custom_out.advance;
+                return;
+            }
+            fmt.format(value, out);
+        }
+
+        // the format_arg::custom thunk for ValueT; reuses a formatter parsed
+        // into cache by an earlier call, when there is one
+        //
+        template <typename ValueT>
+        void format_custom_arg(
+            void const* value,
+            char const** in,
+            char const* end,
+            format_output& out,
+            formatter_cache* cache) {
+            using FormatterT = formatter<ValueT>;
+            FormatterT fmt;
+            if constexpr (is_cacheable_formatter<FormatterT>) {
+                if (cache != nullptr && in != nullptr && cache->owner == &formatter_cache_id<FormatterT>) {
+                    if constexpr (!std::is_empty_v<FormatterT>) {
+                        std::memcpy(&fmt, cache->storage, sizeof fmt);
+                    }
+                    format_custom_value(fmt, *static_cast<ValueT const*>(value), out);
+                    return;
+                }
+            }
+            if (in != nullptr) {
+                *in = fmt.parse(*in, end);
+                if constexpr (is_cacheable_formatter<FormatterT>) {
+                    if (cache != nullptr) {
+                        if constexpr (!std::is_empty_v<FormatterT>) {
+                            std::memcpy(cache->storage, &fmt, sizeof fmt);
+                        }
+                        cache->owner = &formatter_cache_id<FormatterT>;
+                    }
+                }
+            }
+            format_custom_value(fmt, *static_cast<ValueT const*>(value), out);
+        }
+
+        // true if make_format_arg stores the value as format_arg::custom
+        //
+        template <typename ValueT>
+        struct is_custom_format_arg
+            : std::bool_constant<
+                  !std::is_constructible_v<format_arg, typename value_type_map<std::decay_t<ValueT>>::type> &&
+                  has_formatter<ValueT>::value> {};
+        template <typename T>
+        struct is_custom_format_arg<named_arg<T>> : is_custom_format_arg<T> {};
+
         template <typename ValueT>
         constexpr format_arg make_format_arg(ValueT const& value) noexcept {
             using MappedT = typename detail::value_type_map<std::decay_t<ValueT>>::type;
@@ -373,13 +1634,7 @@ namespace NANOFMT_NS {
             }
             else if constexpr (detail::has_formatter<ValueT>::value) {
                 format_arg::custom custom;
-                custom.thunk = +[](void const* value, char const** in, char const* end, format_output& out) {
-                    formatter<ValueT> fmt;
-                    if (in != nullptr) {
-                        *in = fmt.parse(*in, end);
-                    }
-                    fmt.format(*static_cast<ValueT const*>(value), out);
-                };
+                custom.thunk = &format_custom_arg<ValueT>;
                 // this is basically std::addressof, but we want to avoid pulling in <memory> as a dependency
                 custom.value =
                     reinterpret_cast<ValueT*>(&const_cast<char&>(reinterpret_cast<const volatile char&>(value)));
@@ -392,6 +1647,297 @@ namespace NANOFMT_NS {
                 static_assert(always_false_v<ValueT>, "Type has no nanofmt::formatter<> specialization");
             }
         }
+
+        // the format_arg member a builtin value is stored in, found by the
+        // same overload resolution as the format_arg constructors
+        //
+        int format_arg_value(int) noexcept;
+        unsigned format_arg_value(unsigned) noexcept;
+        long format_arg_value(long) noexcept;
+        unsigned long format_arg_value(unsigned long) noexcept;
+        long long format_arg_value(long long) noexcept;
+        unsigned long long format_arg_value(unsigned long long) noexcept;
+        char format_arg_value(char) noexcept;
+        float format_arg_value(float) noexcept;
+        double format_arg_value(double) noexcept;
+        bool format_arg_value(bool) noexcept;
+        char const* format_arg_value(char const*) noexcept;
+        void const* format_arg_value(void const*) noexcept;
+
+        template <typename ValueT>
+        using format_arg_value_t = decltype(format_arg_value(declval<ValueT>()));
+
+        // formats one argument with the formatter that make_format_arg and
+        // format_args would select for it, without erasing its type
+        //
+        template <typename ValueT>
+        void format_inline_arg(ValueT const& value, char const** in, char const* end, format_output& out) {
+            using MappedT = typename detail::value_type_map<std::decay_t<ValueT>>::type;
+            if constexpr (std::is_constructible_v<format_arg, MappedT>) {
+                format_builtin(static_cast<format_arg_value_t<MappedT>>((MappedT)(value)), in, end, out);
+            }
+            else if constexpr (detail::has_formatter<ValueT>::value) {
+                formatter<ValueT> fmt;
+                if (in != nullptr) {
+                    *in = fmt.parse(*in, end);
+                }
+                format_custom_value(fmt, value, out);
+            }
+            else if constexpr (std::is_enum_v<ValueT>) {
+                using UnderlyingT = typename detail::value_type_map<std::underlying_type_t<ValueT>>::type;
+                format_inline_arg(static_cast<UnderlyingT>(value), in, end, out);
+            }
+            else {
+                static_assert(always_false_v<ValueT>, "Type has no nanofmt::formatter<> specialization");
+            }
+        }
+
+        template <typename T>
+        void format_inline_arg(named_arg<T> const& arg, char const** in, char const* end, format_output& out) {
+            format_inline_arg(arg.value, in, end, out);
+        }
+
+        // formats the argument of a prepared field; builtins use the spec
+        // parsed ahead of time, and custom formatters are reused from the
+        // field's cache, as they are through format_args
+        //
+        template <typename ValueT>
+        void format_inline_field(
+            ValueT const& value,
+            format_segment const& field,
+            formatter_cache* cache,
+            format_output& out) {
+            using MappedT = typename detail::value_type_map<std::decay_t<ValueT>>::type;
+            if constexpr (std::is_constructible_v<format_arg, MappedT>) {
+                format_builtin(static_cast<format_arg_value_t<MappedT>>((MappedT)(value)), field, out);
+            }
+            else if constexpr (detail::has_formatter<ValueT>::value) {
+                char const* spec = field.spec;
+                format_custom_arg<ValueT>(&value, spec != nullptr ? &spec : nullptr, field.spec_end, out, cache);
+            }
+            else if constexpr (std::is_enum_v<ValueT>) {
+                using UnderlyingT = typename detail::value_type_map<std::underlying_type_t<ValueT>>::type;
+                format_inline_field(static_cast<UnderlyingT>(value), field, cache, out);
+            }
+            else {
+                static_assert(always_false_v<ValueT>, "Type has no nanofmt::formatter<> specialization");
+            }
+        }
+
+        template <typename T>
+        void format_inline_field(
+            named_arg<T> const& arg,
+            format_segment const& field,
+            formatter_cache* cache,
+            format_output& out) {
+            format_inline_field(arg.value, field, cache, out);
+        }
+
+        template <typename ValueT>
+        constexpr bool is_inline_named(
+            ValueT const& arg,
+            char const* name,
+            std::uint32_t length,
+            std::uint32_t hash) noexcept {
+            if constexpr (is_named_arg<ValueT>::value) {
+                return arg.hash == hash && arg.length == length && __builtin_memcmp(arg.name, name, length) == 0;
+            }
+            else {
+                return false;
+            }
+        }
+
+        // returns the index of the argument with the given name, or -1
+        //
+        template <typename... Args>
+        constexpr int find_inline_named(
+            char const* name,
+            std::uint32_t length,
+            std::uint32_t hash,
+            Args const&... args) noexcept {
+            int index = 0;
+            bool const found = ((is_inline_named(args, name, length, hash) || (++index, false)) || ...);
+            return found ? index : -1;
+        }
+
+        // selects the argument by comparing the index against each position
+        // in turn, which compilers lower to a jump table or a short chain
+        //
+        template <typename... Args>
+        void format_inline_index(
+            unsigned index,
+            char const** in,
+            char const* end,
+            format_output& out,
+            Args const&... args) {
+            unsigned position = 0;
+            (void)((position++ == index ? (format_inline_arg(args, in, end, out), true) : false) || ...);
+        }
+
+        template <typename... Args>
+        void format_inline_field_index(
+            unsigned index,
+            format_segment const& field,
+            formatter_cache* cache,
+            format_output& out,
+            Args const&... args) {
+            unsigned position = 0;
+            (void)((position++ == index ? (format_inline_field(args, field, cache, out), true) : false) || ...);
+        }
+
+        template <typename... Args>
+        void format_inline_dynamic(
+            unsigned index,
+            char const* spec,
+            char const* spec_end,
+            int& arg_next_index,
+            bool& arg_auto_index,
+            format_output& out,
+            Args const&... args) {
+            char buffer[dynamic_spec_capacity];
+            char const* resolved = buffer;
+            char const* resolved_end = nullptr;
+            if (resolve_dynamic_spec(
+                    spec,
+                    spec_end,
+                    ::NANOFMT_NS::make_format_args(args...),
+                    arg_next_index,
+                    arg_auto_index,
+                    buffer,
+                    resolved_end)) {
+                format_inline_index(index, &resolved, resolved_end, out, args...);
+            }
+        }
+
+        template <typename... Args>
+        format_output vformat_inline(format_output out, format_string format_str, Args const&... args) {
+            if (format_segment_data const* const prepared = format_str.prepared; prepared != nullptr) {
+                for (std::size_t index = 0; index != prepared->count; ++index) {
+                    format_segment const& segment = prepared->segments[index];
+                    append_text(out, segment.text, segment.length);
+                    int arg_index = segment.arg_index;
+                    if (arg_index == named_arg_index) {
+                        arg_index = find_inline_named(segment.name, segment.name_length, segment.name_hash, args...);
+                    }
+                    if (arg_index < 0) {
+                        continue;
+                    }
+
+                    if (segment.dynamic) {
+                        int arg_next_index = segment.nested_arg_index;
+                        bool arg_auto_index = true;
+                        format_inline_dynamic(
+                            static_cast<unsigned>(arg_index),
+                            segment.spec,
+                            segment.spec_end,
+                            arg_next_index,
+                            arg_auto_index,
+                            out,
+                            args...);
+                    }
+                    else {
+                        format_inline_field_index(
+                            static_cast<unsigned>(arg_index),
+                            segment,
+                            prepared->caches != nullptr ? prepared->caches + index : nullptr,
+                            out,
+                            args...);
+                    }
+                }
+                return out;
+            }
+
+            // the same scan as vformat, differing only in how each
+            // replacement field reaches its argument
+            //
+            int arg_next_index = 0;
+            bool arg_auto_index = true;
+
+            char const* input = format_str.begin;
+            char const* input_begin = input;
+            char const* const input_end = format_str.end;
+
+            while (input != input_end) {
+                input = find_open_brace(input, input_end);
+                if (input == input_end) {
+                    break;
+                }
+
+                append_text(out, input_begin, input - input_begin);
+
+                ++input;
+                if (input == input_end) {
+                    return out;
+                }
+
+                if (*input == '{') {
+                    input_begin = input++;
+                    continue;
+                }
+
+                int arg_index = 0;
+                if (arg_index = parse_nonnegative(input, input_end); arg_index != -1) {
+                    arg_auto_index = false;
+                }
+                else if (char const* const name_end = parse_name(input, input_end); name_end != input) {
+                    auto const length = static_cast<std::uint32_t>(name_end - input);
+                    arg_index = find_inline_named(input, length, hash_name(input, name_end), args...);
+                    input = name_end;
+                }
+                else if (arg_auto_index) {
+                    arg_index = arg_next_index++;
+                }
+                else {
+                    return out;
+                }
+
+                char const* spec = nullptr;
+                if (input != input_end && *input == ':') {
+                    spec = ++input;
+                }
+
+                bool nested = false;
+                char const* const spec_end = spec != nullptr ? find_spec_end(input, input_end, nested) : input;
+                int nested_arg_index = arg_next_index;
+                if (nested && !skip_nested_fields(spec, spec_end, arg_next_index, arg_auto_index)) {
+                    arg_index = -1;
+                }
+
+                input = spec_end;
+                while (input != input_end && *input != '}') {
+                    ++input;
+                }
+
+                if (arg_index != -1 && nested) {
+                    bool nested_auto_index = true;
+                    format_inline_dynamic(
+                        static_cast<unsigned>(arg_index),
+                        spec,
+                        spec_end,
+                        nested_arg_index,
+                        nested_auto_index,
+                        out,
+                        args...);
+                }
+                else if (arg_index != -1) {
+                    format_inline_index(
+                        static_cast<unsigned>(arg_index),
+                        spec != nullptr ? &spec : nullptr,
+                        spec_end,
+                        out,
+                        args...);
+                }
+
+                if (input != input_end) {
+                    ++input;
+                }
+
+                input_begin = input;
+            }
+
+            append_text(out, input_begin, input - input_begin);
+            return out;
+        }
     } // namespace detail
 } // namespace NANOFMT_NS
 
@@ -12,6 +12,7 @@ namespace NANOFMT_NS {
     struct format_string;
     struct format_string_view;
     struct format_output;
+    struct format_sink;
     template <typename T>
     struct formatter;
 } // namespace NANOFMT_NS
@@ -0,0 +1,191 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#ifndef NANOFMT_MEMORY_BUFFER_H_
+#define NANOFMT_MEMORY_BUFFER_H_ 1
+#pragma once
+
+#include "config.h"
+#include "format.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace NANOFMT_NS {
+    /// Allocates with the global operator new, returning nullptr rather than
+    /// throwing when memory is exhausted.
+    struct heap_allocator {
+        char* allocate(std::size_t size) noexcept { return static_cast<char*>(::operator new(size, std::nothrow)); }
+        void deallocate(char* memory, std::size_t) noexcept { ::operator delete(memory); }
+    };
+
+    /// A buffer of unbounded length, which holds the first N characters
+    /// formatted into it inline and moves to memory from AllocatorT once
+    /// those overflow.
+    ///
+    /// Formats in a single pass: output is written through a format_sink
+    /// whose chunk is the unused tail of the buffer, and the chunk's flush
+    /// grows the buffer geometrically. AllocatorT provides allocate and
+    /// deallocate as std::allocator<char> does, and must not throw; should
+    /// allocate return nullptr, the buffer stops growing, and any further
+    /// output is dropped and sets truncated.
+    ///
+    /// The contents are not NUL-terminated.
+    template <std::size_t N, typename AllocatorT = heap_allocator>
+    struct basic_memory_buffer {
+        static_assert(N != 0, "basic_memory_buffer must have some inline storage");
+
+        basic_memory_buffer() noexcept = default;
+        explicit basic_memory_buffer(AllocatorT const& alloc) noexcept : allocator(alloc) {}
+        ~basic_memory_buffer();
+
+        basic_memory_buffer(basic_memory_buffer const&) = delete;
+        basic_memory_buffer& operator=(basic_memory_buffer const&) = delete;
+
+        /// Formats onto the end of the buffer's contents.
+        template <typename... Args>
+        basic_memory_buffer& format(format_string format_str, Args const&... args);
+
+        inline basic_memory_buffer& vformat(format_string format_str, format_args args);
+
+        /// Appends count characters from source.
+        basic_memory_buffer& append(char const* source, std::size_t count);
+
+        char* data() noexcept { return storage; }
+        char const* data() const noexcept { return storage; }
+        std::size_t size() const noexcept { return length; }
+        std::size_t capacity() const noexcept { return storage_capacity; }
+
+        /// Empties the buffer, keeping its storage.
+        void clear() noexcept;
+
+        /// Grows the storage to hold at least new_capacity characters.
+        /// Returns false if that could not be allocated.
+        bool reserve(std::size_t new_capacity) noexcept;
+
+        char inline_storage[N] = {};
+        char* storage = inline_storage;
+        std::size_t length = 0;
+        std::size_t storage_capacity = N;
+        bool truncated = false;
+        AllocatorT allocator;
+
+        // output past a failed allocation goes here, and is discarded
+        char overflow[16] = {};
+    };
+
+    /// A basic_memory_buffer with 500 bytes of inline storage, enough for
+    /// most messages to never allocate.
+    using memory_buffer = basic_memory_buffer<500>;
+
+    template <std::size_t N, typename AllocatorT>
+    basic_memory_buffer<N, AllocatorT>::~basic_memory_buffer() {
+        if (storage != inline_storage) {
+            allocator.deallocate(storage, storage_capacity);
+        }
+    }
+
+    template <std::size_t N, typename AllocatorT>
+    template <typename... Args>
+    basic_memory_buffer<N, AllocatorT>& basic_memory_buffer<N, AllocatorT>::format(
+        format_string format_str,
+        Args const&... args) {
+        return vformat(format_str, ::NANOFMT_NS::make_format_args(args...));
+    }
+
+    template <std::size_t N, typename AllocatorT>
+    basic_memory_buffer<N, AllocatorT>& basic_memory_buffer<N, AllocatorT>::vformat(
+        format_string format_str,
+        format_args args) {
+        // the sink's chunk is the unused tail of the storage; each flush
+        // takes what was written into the contents, and makes the tail of
+        // the grown storage the next chunk
+        //
+        struct growth {
+            basic_memory_buffer* self = nullptr;
+            format_sink* sink = nullptr;
+
+            void next_chunk() noexcept {
+                if (self->length == self->storage_capacity) {
+                    sink->chunk = self->overflow;
+                    sink->capacity = sizeof self->overflow;
+                    return;
+                }
+                sink->chunk = self->storage + self->length;
+                sink->capacity = self->storage_capacity - self->length;
+            }
+        };
+
+        auto const flush = [](void* context, char const* data, std::size_t written) noexcept {
+            auto& state = *static_cast<growth*>(context);
+            if (data == state.self->overflow) {
+                state.self->truncated = true;
+                return;
+            }
+
+            state.self->length += written;
+            if (state.self->length == state.self->storage_capacity) {
+                state.self->reserve(state.self->storage_capacity * 2);
+            }
+            state.next_chunk();
+        };
+
+        if (length == storage_capacity) {
+            reserve(storage_capacity * 2);
+        }
+
+        format_sink sink(overflow, flush);
+        growth state{this, &sink};
+        sink.context = &state;
+        state.next_chunk();
+
+        format_output out = sink.output();
+        out.vformat(format_str, static_cast<format_args&&>(args));
+        out.flush();
+        return *this;
+    }
+
+    template <std::size_t N, typename AllocatorT>
+    basic_memory_buffer<N, AllocatorT>& basic_memory_buffer<N, AllocatorT>::append(
+        char const* source,
+        std::size_t count) {
+        if (length + count > storage_capacity) {
+            std::size_t const doubled = storage_capacity * 2;
+            reserve(doubled > length + count ? doubled : length + count);
+        }
+
+        std::size_t const copied = count < storage_capacity - length ? count : storage_capacity - length;
+        std::memcpy(storage + length, source, copied);
+        length += copied;
+        truncated = truncated || copied != count;
+        return *this;
+    }
+
+    template <std::size_t N, typename AllocatorT>
+    void basic_memory_buffer<N, AllocatorT>::clear() noexcept {
+        length = 0;
+        truncated = false;
+    }
+
+    template <std::size_t N, typename AllocatorT>
+    bool basic_memory_buffer<N, AllocatorT>::reserve(std::size_t new_capacity) noexcept {
+        if (new_capacity <= storage_capacity) {
+            return true;
+        }
+
+        char* const grown = allocator.allocate(new_capacity);
+        if (grown == nullptr) {
+            return false;
+        }
+
+        std::memcpy(grown, storage, length);
+        if (storage != inline_storage) {
+            allocator.deallocate(storage, storage_capacity);
+        }
+        storage = grown;
+        storage_capacity = new_capacity;
+        return true;
+    }
+} // namespace NANOFMT_NS
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#pragma once
+
+#include "nanofmt/config.h"
+
+#include <cstdint>
+
+namespace NANOFMT_NS::detail {
+    // fixed-capacity unsigned integer, stored as little-endian 32-bit limbs;
+    // only the handful of operations needed for exact decimal conversion of
+    // floating point values are provided, and callers are responsible for
+    // sizing Limbs so that no operation overflows
+    //
+    template <int Limbs>
+    struct bigint {
+        std::uint32_t limbs[Limbs] = {};
+        int size = 0;
+
+        constexpr explicit bigint(std::uint64_t value) noexcept {
+            while (value != 0) {
+                limbs[size++] = static_cast<std::uint32_t>(value);
+                value >>= 32;
+            }
+        }
+
+        constexpr bool is_zero() const noexcept { return size == 0; }
+
+        constexpr bool is_odd() const noexcept { return size != 0 && (limbs[0] & 1u) != 0; }
+
+        constexpr void add(std::uint32_t addend) noexcept {
+            std::uint64_t carry = addend;
+            for (int index = 0; carry != 0 && index != size; ++index) {
+                carry += limbs[index];
+                limbs[index] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            if (carry != 0) {
+                limbs[size++] = static_cast<std::uint32_t>(carry);
+            }
+        }
+
+        constexpr void multiply(std::uint32_t factor) noexcept {
+            std::uint64_t carry = 0;
+            for (int index = 0; index != size; ++index) {
+                carry += static_cast<std::uint64_t>(limbs[index]) * factor;
+                limbs[index] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            if (carry != 0) {
+                limbs[size++] = static_cast<std::uint32_t>(carry);
+            }
+        }
+
+        constexpr void multiply_wide(std::uint64_t factor) noexcept {
+            auto const low = static_cast<std::uint32_t>(factor);
+            auto const high = static_cast<std::uint32_t>(factor >> 32);
+            if (high == 0) {
+                multiply(low);
+                return;
+            }
+
+            // schoolbook multiply by the two limbs of factor, into separate
+            // storage as each source limb contributes to three result limbs
+            //
+            std::uint32_t const factors[2] = {low, high};
+            std::uint32_t result[Limbs + 2] = {};
+            for (int index = 0; index != size; ++index) {
+                std::uint64_t carry = 0;
+                for (int part = 0; part != 2; ++part) {
+                    carry += static_cast<std::uint64_t>(limbs[index]) * factors[part] + result[index + part];
+                    result[index + part] = static_cast<std::uint32_t>(carry);
+                    carry >>= 32;
+                }
+                result[index + 2] = static_cast<std::uint32_t>(carry);
+            }
+
+            size += 2;
+            for (int index = 0; index != size; ++index) {
+                limbs[index] = result[index];
+            }
+            while (size != 0 && limbs[size - 1] == 0) {
+                --size;
+            }
+        }
+
+        // returns the remainder
+        //
+        constexpr std::uint32_t divide(std::uint32_t divisor) noexcept {
+            std::uint64_t remainder = 0;
+            for (int index = size; index-- != 0;) {
+                remainder = (remainder << 32) | limbs[index];
+                limbs[index] = static_cast<std::uint32_t>(remainder / divisor);
+                remainder %= divisor;
+            }
+            while (size != 0 && limbs[size - 1] == 0) {
+                --size;
+            }
+            return static_cast<std::uint32_t>(remainder);
+        }
+
+        constexpr void shift_left(int bits) noexcept {
+            if (size == 0) {
+                return;
+            }
+
+            int const whole = bits / 32;
+            int const partial = bits % 32;
+
+            limbs[size + whole] = 0;
+            for (int index = size; index-- != 0;) {
+                std::uint64_t const wide = static_cast<std::uint64_t>(limbs[index]) << partial;
+                limbs[index + whole + 1] |= static_cast<std::uint32_t>(wide >> 32);
+                limbs[index + whole] = static_cast<std::uint32_t>(wide);
+            }
+            for (int index = 0; index != whole; ++index) {
+                limbs[index] = 0;
+            }
+
+            size += whole + 1;
+            if (limbs[size - 1] == 0) {
+                --size;
+            }
+        }
+
+        constexpr void shift_right(int bits) noexcept {
+            int const whole = bits / 32;
+            int const partial = bits % 32;
+
+            if (whole >= size) {
+                size = 0;
+                return;
+            }
+
+            for (int index = whole; index != size; ++index) {
+                std::uint64_t const high = index + 1 != size ? limbs[index + 1] : 0;
+                std::uint64_t const wide = (high << 32) | limbs[index];
+                limbs[index - whole] = static_cast<std::uint32_t>(wide >> partial);
+            }
+            for (int index = size - whole; index != size; ++index) {
+                limbs[index] = 0;
+            }
+
+            size -= whole;
+            while (size != 0 && limbs[size - 1] == 0) {
+                --size;
+            }
+        }
+
+        constexpr bool bit(int index) const noexcept {
+            int const limb = index / 32;
+            return limb < size && ((limbs[limb] >> (index % 32)) & 1u) != 0;
+        }
+
+        // true if any bit below the given index is set
+        //
+        constexpr bool any_below(int index) const noexcept {
+            int const whole = index / 32;
+            for (int limb = 0; limb != whole && limb != size; ++limb) {
+                if (limbs[limb] != 0) {
+                    return true;
+                }
+            }
+            std::uint32_t const mask = (std::uint32_t{1} << (index % 32)) - 1;
+            return whole < size && (limbs[whole] & mask) != 0;
+        }
+    };
+
+    // returns a negative value, zero, or a positive value when lhs is less
+    // than, equal to, or greater than rhs
+    //
+    template <int Limbs>
+    constexpr int compare(bigint<Limbs> const& lhs, bigint<Limbs> const& rhs) noexcept {
+        if (lhs.size != rhs.size) {
+            return lhs.size < rhs.size ? -1 : 1;
+        }
+        for (int index = lhs.size; index-- != 0;) {
+            if (lhs.limbs[index] != rhs.limbs[index]) {
+                return lhs.limbs[index] < rhs.limbs[index] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+} // namespace NANOFMT_NS::detail
@@ -1,13 +1,19 @@
 // Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
 
 #include "nanofmt/charconv.h"
+#include "bigint_utils.h"
 #include "numeric_utils.h"
+#include "parse_utils.h"
+#include "simd_utils.h"
 #if NANOFMT_FLOAT
 #    include "nanofmt/dragonbox.h"
 #endif
 #include "nanofmt/format.h"
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 namespace NANOFMT_NS::detail {
     template <typename IntegerT>
@@ -16,17 +22,66 @@ namespace NANOFMT_NS::detail {
     template <typename CarrierT, typename FloatT>
     static char* to_chars_impl(char* dest, char const* end, FloatT value, float_format fmt, int precision) noexcept;
 
+    template <typename IntegerT>
+    static to_chars_many_result to_chars_many_impl(
+        char* dest,
+        char const* end,
+        IntegerT const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept;
+
+    template <typename IntegerT, typename KernelT>
+    static to_chars_many_result to_chars_many_kernel(
+        char* dest,
+        char const* end,
+        IntegerT const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt,
+        KernelT kernel) noexcept;
+
     template <typename UnsignedIntT>
     static char* to_chars_impl_decimal(char* dest, char const* end, UnsignedIntT value) noexcept;
 
-    template <char A = 'a', typename UnsignedIntT>
-    static char* to_chars_impl_hex(char* dest, char const* end, UnsignedIntT value) noexcept;
+    template <int DigitBits, int GroupDigits, typename UnsignedIntT>
+    static char* to_chars_impl_radix(char* dest, char const* end, UnsignedIntT value, char const* table) noexcept;
 
-    template <typename UnsignedIntT>
-    static char* to_chars_impl_binary(char* dest, char const* end, UnsignedIntT value) noexcept;
+    template <char A = 'a'>
+    static char* to_chars_impl_hex64(char* dest, char const* end, std::uint64_t value) noexcept;
+
+    template <char A>
+    static void hex64_digits(std::uint64_t value, char* digits) noexcept;
+
+    static char* to_chars_impl_prefix(char* dest, char const* end, int_format fmt, bool nonzero) noexcept;
+
+    template <typename IntegerT>
+    static from_chars_result from_chars_impl(
+        char const* first,
+        char const* last,
+        IntegerT& value,
+        int_format fmt) noexcept;
+
+    static char const* from_chars_prefix(char const* first, char const* last, int_format fmt) noexcept;
+
+    static char const* from_chars_decimal(
+        char const* first,
+        char const* last,
+        std::uint64_t& value,
+        bool& overflow) noexcept;
+
+    template <int DigitBits>
+    static char const* from_chars_radix(
+        char const* first,
+        char const* last,
+        std::uint64_t& value,
+        bool& overflow) noexcept;
 
     template <typename UnsignedIntT>
-    static char* to_chars_n_round(char* dest, char const* end, UnsignedIntT value, std::size_t count) noexcept;
+    static char* to_chars_impl_decimal_padded(char* dest, char const* end, UnsignedIntT value, int width) noexcept;
+
+    template <typename CarrierT>
+    static void round_significand(CarrierT& significand, int& exponent, int place) noexcept;
 
     template <char E = 'e', bool TrailingZeroes = true, typename CarrierT>
     char* to_chars_impl_scientific(
@@ -52,17 +107,132 @@ namespace NANOFMT_NS::detail {
         int exponent,
         int precision) noexcept;
 
+    template <char E = 'e', bool TrailingZeroes = true>
+    static char* to_chars_impl_scientific_digits(
+        char* dest,
+        char const* end,
+        char const* digits,
+        int count,
+        int exponent,
+        int precision) noexcept;
+
+    template <bool TrailingZeroes = true>
+    static char* to_chars_impl_fixed_digits(
+        char* dest,
+        char const* end,
+        char const* digits,
+        int count,
+        int exponent,
+        int precision) noexcept;
+
+    template <char E>
+    static char* to_chars_impl_exponent(char* dest, char const* end, int exponent) noexcept;
+
 #if NANOFMT_FLOAT
+    template <typename CarrierT, typename FloatT>
+    static bool to_decimal_exact(FloatT value, CarrierT& significand, int& exponent) noexcept;
+
+    template <typename FloatT, typename CarrierT>
+    static bool needs_exact_digits(
+        FloatT value,
+        float_format fmt,
+        CarrierT significand,
+        int exponent,
+        int precision) noexcept;
+
+    template <typename CarrierT, typename FloatT>
+    static char* to_chars_impl_exact(
+        char* dest,
+        char const* end,
+        FloatT value,
+        float_format fmt,
+        int precision,
+        int adjusted_exp) noexcept;
+
+    template <typename CarrierT, typename FloatT>
+    static char* to_digits_exact(char* dest, char const* end, FloatT value, int place, int& exponent) noexcept;
+
+    template <typename CarrierT, typename FloatT>
+    static char* to_digits_exact_significant(
+        char* dest,
+        char const* end,
+        FloatT value,
+        int significant,
+        int adjusted_exp,
+        int& exponent) noexcept;
+
+    template <char P = 'p', typename CarrierT, typename FloatT>
+    static char* to_chars_impl_hex(char* dest, char const* end, FloatT value, int precision) noexcept;
+
     static char* to_chars_impl_nonfinite(
         char* dest,
         char const* end,
         bool negative,
         bool infinite,
         bool upper) noexcept;
+
+    // the extents of a parsed decimal number, so that the exact fallback can
+    // re-read the digits that do not fit in a 64-bit significand
+    //
+    struct decimal_digits {
+        char const* integer_first = nullptr;
+        char const* integer_last = nullptr;
+        char const* fraction_first = nullptr;
+        char const* fraction_last = nullptr;
+        int exponent = 0;
+    };
+
+    template <typename CarrierT, typename FloatT>
+    static from_chars_result from_chars_impl(
+        char const* first,
+        char const* last,
+        FloatT& value,
+        float_format fmt) noexcept;
+
+    static char const* from_chars_nonfinite(char const* first, char const* last, bool& infinite) noexcept;
+
+    static char const* from_chars_significand(
+        char const* first,
+        char const* last,
+        std::uint64_t& significand,
+        int& digits,
+        int& dropped,
+        bool& truncated) noexcept;
+
+    template <typename CarrierT>
+    static bool eisel_lemire(std::uint64_t significand, int exponent, CarrierT& bits) noexcept;
+
+    template <typename CarrierT, typename FloatT>
+    static CarrierT from_chars_exact(decimal_digits const& digits, CarrierT bits) noexcept;
 #endif
 
-    // maximum significand for double is 17 decimal digits
-    static constexpr size_t significand_max_digits10 = 17;
+    // lookup table for power-of-two bases, where each entry holds the
+    // characters for GroupDigits consecutive digits
+    //
+    template <int DigitBits, int GroupDigits>
+    struct radix_table {
+        static constexpr int entries = 1 << (DigitBits * GroupDigits);
+
+        constexpr explicit radix_table(char const* alphabet) noexcept {
+            constexpr int digit_mask = (1 << DigitBits) - 1;
+            for (int entry = 0; entry != entries; ++entry) {
+                for (int digit = 0; digit != GroupDigits; ++digit) {
+                    int const shift = (GroupDigits - 1 - digit) * DigitBits;
+                    chars[entry * GroupDigits + digit] = alphabet[(entry >> shift) & digit_mask];
+                }
+            }
+        }
+
+        char chars[entries * GroupDigits] = {};
+    };
+
+    // hex emits a byte (two digits) per step, octal six bits (two digits)
+    // per step, and binary a nibble (four digits) per step
+    //
+    static constexpr radix_table<4, 2> hex_lower_table{"0123456789abcdef"};
+    static constexpr radix_table<4, 2> hex_upper_table{"0123456789ABCDEF"};
+    static constexpr radix_table<3, 2> octal_table{"01234567"};
+    static constexpr radix_table<1, 4> binary_table{"01"};
 } // namespace NANOFMT_NS::detail
 
 namespace NANOFMT_NS {
@@ -106,6 +276,146 @@ namespace NANOFMT_NS {
         return detail::to_chars_impl(dest, end, value, fmt);
     }
 
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        signed char const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        unsigned char const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        signed short const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        unsigned short const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        signed int const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        unsigned int const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        signed long const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        unsigned long const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        signed long long const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    to_chars_many_result to_chars_many(
+        char* dest,
+        char const* end,
+        unsigned long long const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        return detail::to_chars_many_impl(dest, end, values, count, separator, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, signed char& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, unsigned char& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, signed short& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, unsigned short& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, signed int& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, unsigned int& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, signed long& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, unsigned long& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, signed long long& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, unsigned long long& value, int_format fmt) noexcept {
+        return detail::from_chars_impl(first, last, value, fmt);
+    }
+
 #if NANOFMT_FLOAT
     char* to_chars(char* dest, char const* end, float value, float_format fmt) noexcept {
         return detail::to_chars_impl<std::uint32_t>(dest, end, value, fmt, -1);
@@ -122,17 +432,26 @@ namespace NANOFMT_NS {
     char* to_chars(char* dest, char const* end, double value, float_format fmt, int precision) noexcept {
         return detail::to_chars_impl<std::uint64_t>(dest, end, value, fmt, precision);
     }
+
+    from_chars_result from_chars(char const* first, char const* last, float& value, float_format fmt) noexcept {
+        return detail::from_chars_impl<std::uint32_t>(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(char const* first, char const* last, double& value, float_format fmt) noexcept {
+        return detail::from_chars_impl<std::uint64_t>(first, last, value, fmt);
+    }
 #endif
 
     template <typename IntegerT>
     char* detail::to_chars_impl(char* dest, char const* end, IntegerT value, int_format fmt) noexcept {
-        if (value < 0 && dest != end) {
-            *dest++ = '-';
+        if (value < 0) {
+            dest = put(dest, end, '-');
         }
 
+        dest = to_chars_impl_prefix(dest, end, fmt, value != 0);
+
         if (value == 0) {
-            *dest++ = '0';
-            return dest;
+            return put(dest, end, '0');
         }
 
         auto const abs_value = detail::abs(value);
@@ -141,16 +460,130 @@ namespace NANOFMT_NS {
             case int_format::decimal:
                 return detail::to_chars_impl_decimal(dest, end, abs_value);
             case int_format::hex:
-                return detail::to_chars_impl_hex<'a'>(dest, end, abs_value);
+            case int_format::hex_prefixed:
+                if constexpr (sizeof(abs_value) >= 4) {
+                    return detail::to_chars_impl_hex64<'a'>(dest, end, abs_value);
+                }
+                return detail::to_chars_impl_radix<4, 2>(dest, end, abs_value, hex_lower_table.chars);
             case int_format::hex_upper:
-                return detail::to_chars_impl_hex<'A'>(dest, end, abs_value);
+            case int_format::hex_upper_prefixed:
+                if constexpr (sizeof(abs_value) >= 4) {
+                    return detail::to_chars_impl_hex64<'A'>(dest, end, abs_value);
+                }
+                return detail::to_chars_impl_radix<4, 2>(dest, end, abs_value, hex_upper_table.chars);
             case int_format::binary:
-                return detail::to_chars_impl_binary(dest, end, abs_value);
+            case int_format::binary_prefixed:
+            case int_format::binary_upper_prefixed:
+                return detail::to_chars_impl_radix<1, 4>(dest, end, abs_value, binary_table.chars);
+            case int_format::octal:
+            case int_format::octal_prefixed:
+                return detail::to_chars_impl_radix<3, 2>(dest, end, abs_value, octal_table.chars);
             default:
                 return dest;
         }
     }
 
+    template <typename IntegerT>
+    to_chars_many_result detail::to_chars_many_impl(
+        char* dest,
+        char const* end,
+        IntegerT const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt) noexcept {
+        // select the kernel once for the whole list, rather than once per value
+        //
+        switch (fmt) {
+            case int_format::decimal:
+                return to_chars_many_kernel(dest, end, values, count, separator, fmt, [](char* d, char const* e, auto v) {
+                    return to_chars_impl_decimal(d, e, v);
+                });
+            case int_format::hex:
+            case int_format::hex_prefixed:
+                return to_chars_many_kernel(dest, end, values, count, separator, fmt, [](char* d, char const* e, auto v) {
+                    if constexpr (sizeof(v) >= 4) {
+                        return to_chars_impl_hex64<'a'>(d, e, v);
+                    }
+                    return to_chars_impl_radix<4, 2>(d, e, v, hex_lower_table.chars);
+                });
+            case int_format::hex_upper:
+            case int_format::hex_upper_prefixed:
+                return to_chars_many_kernel(dest, end, values, count, separator, fmt, [](char* d, char const* e, auto v) {
+                    if constexpr (sizeof(v) >= 4) {
+                        return to_chars_impl_hex64<'A'>(d, e, v);
+                    }
+                    return to_chars_impl_radix<4, 2>(d, e, v, hex_upper_table.chars);
+                });
+            case int_format::binary:
+            case int_format::binary_prefixed:
+            case int_format::binary_upper_prefixed:
+                return to_chars_many_kernel(dest, end, values, count, separator, fmt, [](char* d, char const* e, auto v) {
+                    return to_chars_impl_radix<1, 4>(d, e, v, binary_table.chars);
+                });
+            case int_format::octal:
+            case int_format::octal_prefixed:
+                return to_chars_many_kernel(dest, end, values, count, separator, fmt, [](char* d, char const* e, auto v) {
+                    return to_chars_impl_radix<3, 2>(d, e, v, octal_table.chars);
+                });
+            default:
+                return {dest, 0};
+        }
+    }
+
+    template <typename IntegerT, typename KernelT>
+    to_chars_many_result detail::to_chars_many_kernel(
+        char* dest,
+        char const* end,
+        IntegerT const* values,
+        std::size_t count,
+        char const* separator,
+        int_format fmt,
+        KernelT kernel) noexcept {
+        // widest possible value: binary digits, plus a sign and prefix
+        //
+        constexpr std::size_t max_chars = sizeof(IntegerT) * 8 + 3;
+
+        std::size_t const separator_length = separator != nullptr ? __builtin_strlen(separator) : 0;
+
+        auto write_value = [fmt, kernel](char* d, char const* e, IntegerT value) noexcept {
+            if (value < 0) {
+                d = put(d, e, '-');
+            }
+            d = to_chars_impl_prefix(d, e, fmt, value != 0);
+            if (value == 0) {
+                return put(d, e, '0');
+            }
+            return kernel(d, e, abs(value));
+        };
+
+        for (std::size_t index = 0; index != count; ++index) {
+            std::size_t const gap = index != 0 ? separator_length : 0;
+            std::size_t const available = end - dest;
+
+            // while the buffer has room for the widest possible value, write
+            // straight into the destination without any bounds bookkeeping
+            //
+            if (available >= gap + max_chars) {
+                dest = copy_to_n(dest, end, separator, gap);
+                dest = write_value(dest, end, values[index]);
+                continue;
+            }
+
+            // near the end of the buffer, format into scratch space first
+            // so that a value which does not fit is not partially written
+            //
+            char scratch[max_chars];
+            std::size_t const length = write_value(scratch, scratch + sizeof scratch, values[index]) - scratch;
+            if (available < gap + length) {
+                return {dest, index};
+            }
+            dest = copy_to_n(dest, end, separator, gap);
+            dest = copy_to_n(dest, end, scratch, length);
+        }
+
+        return {dest, count};
+    }
+
     template <typename CarrierT, typename FloatT>
     char* detail::to_chars_impl(char* dest, char const* end, FloatT value, float_format fmt, int precision) noexcept {
         static_assert(sizeof(CarrierT) == sizeof(FloatT));
@@ -159,6 +592,7 @@ namespace NANOFMT_NS {
             switch (fmt) {
                 case float_format::scientific_upper:
                 case float_format::general_upper:
+                case float_format::hex_upper:
                     return to_chars_impl_nonfinite(dest, end, std::signbit(value), std::isinf(value), /*upper=*/true);
                 default:
                     return to_chars_impl_nonfinite(
@@ -170,23 +604,41 @@ namespace NANOFMT_NS {
             }
         }
 
+        // sign
+        if (std::signbit(value)) {
+            dest = put(dest, end, '-');
+        }
+
+        // hex formatting works directly on the binary representation, so
+        // there is no need for a decimal conversion
+        //
+        if (fmt == float_format::hex) {
+            return detail::to_chars_impl_hex<'p', CarrierT>(dest, end, value, precision);
+        }
+        if (fmt == float_format::hex_upper) {
+            return detail::to_chars_impl_hex<'P', CarrierT>(dest, end, value, precision);
+        }
+
         CarrierT significand = 0;
         int exponent = 0;
 
-        if (value != 0) {
-            auto const db_result = nanofmt::dragonbox::to_decimal(
+        if (value != 0 && !to_decimal_exact(value, significand, exponent)) {
+            auto const db_result = NANOFMT_NS::dragonbox::to_decimal(
                 value,
-                nanofmt::dragonbox::policy::sign::ignore,
-                nanofmt::dragonbox::policy::cache::compact,
-                nanofmt::dragonbox::policy::trailing_zero::remove,
-                nanofmt::dragonbox::policy::binary_to_decimal_rounding::to_even);
+                NANOFMT_NS::dragonbox::policy::sign::ignore,
+                NANOFMT_NS::dragonbox::policy::cache::compact,
+                NANOFMT_NS::dragonbox::policy::trailing_zero::remove,
+                NANOFMT_NS::dragonbox::policy::binary_to_decimal_rounding::to_even);
             significand = db_result.significand;
             exponent = db_result.exponent;
-        }
 
-        // sign
-        if (std::signbit(value)) {
-            dest = put(dest, end, '-');
+            // the shortest digits only approximate the value; when the requested
+            // precision can tell the difference, generate the exact digits instead
+            //
+            if (needs_exact_digits(value, fmt, significand, exponent, precision)) {
+                int const adjusted_exp = exponent + count_digits(significand) - 1;
+                return detail::to_chars_impl_exact<CarrierT>(dest, end, value, fmt, precision, adjusted_exp);
+            }
         }
 
         switch (fmt) {
@@ -200,8 +652,6 @@ namespace NANOFMT_NS {
                 return detail::to_chars_impl_general(dest, end, significand, exponent, precision);
             case float_format::general_upper:
                 return detail::to_chars_impl_general<'E'>(dest, end, significand, exponent, precision);
-            case float_format::hex: // FIXME: implement
-            case float_format::hex_upper: // FIXME: implement
             default:
                 return dest;
         }
@@ -229,201 +679,471 @@ namespace NANOFMT_NS {
             value = rshift10(value, total_digits - digits);
         }
 
-        // write digits; FIXME add table to do this in two-digit
-        // batches to reduce divisions
+        // write digits from least to most significant, two at a time, so
+        // that each division produces a pair of digits from the table
         //
         char* ptr = dest + digits;
-        do {
-            *--ptr = '0' + (value % 10);
-            value /= 10;
-        } while (value != 0);
+        while (value >= 100u) {
+            unsigned const pair = static_cast<unsigned>(value % 100u) * 2;
+            value /= 100u;
+            ptr -= 2;
+            ptr[0] = decimal_digit_pairs[pair];
+            ptr[1] = decimal_digit_pairs[pair + 1];
+        }
+        if (value >= 10u) {
+            unsigned const pair = static_cast<unsigned>(value) * 2;
+            ptr[-2] = decimal_digit_pairs[pair];
+            ptr[-1] = decimal_digit_pairs[pair + 1];
+        }
+        else {
+            ptr[-1] = static_cast<char>('0' + value);
+        }
 
         return dest + digits;
     }
 
-    template <char A, typename UnsignedIntT>
-    char* detail::to_chars_impl_hex(char* dest, char const* end, UnsignedIntT value) noexcept {
+    template <int DigitBits, int GroupDigits, typename UnsignedIntT>
+    char* detail::to_chars_impl_radix(char* dest, char const* end, UnsignedIntT value, char const* table) noexcept {
         static_assert(std::is_unsigned_v<UnsignedIntT>);
 
-        // constants to process nibbles (half-bytes, or 4 bits)
-        //
-        constexpr int bits_per_nibble = 4;
-        constexpr int nibbles_per_byte = 2;
-        constexpr int total_nibbles = sizeof(value) * nibbles_per_byte;
-        constexpr UnsignedIntT nibble_mask = 0b1111;
+        constexpr int group_bits = DigitBits * GroupDigits;
+        constexpr unsigned group_mask = (1u << group_bits) - 1;
 
-        // find the first non-zero nibble for our initial position
-        //
-        int const zero_nibbles = countl_zero(value) >> nibbles_per_byte;
-        int shift = (total_nibbles - zero_nibbles - 1) * bits_per_nibble;
-        UnsignedIntT mask = nibble_mask << shift;
+        if (dest == end) {
+            return dest;
+        }
 
-        // continously "chop" nibbles off the integer for generating
-        // the appropriate hex digit
-        //
-        // works MSB to LSB so that we can early-terminate when the
-        // output buffer is full
+        // the digit count follows directly from the position of the most
+        // significant set bit
         //
-        // we slide the mask as we chop nibbles and have finished
-        // when the mask completely slides off to zero
+        int const value_bits = static_cast<int>(sizeof(value) * 8) - countl_zero(value);
+        int const total_digits = (value_bits + DigitBits - 1) / DigitBits;
+        size_t const available = end - dest;
+        int const digits = min<int>(total_digits, static_cast<int>(available));
+
+        // trim any trailing digits if our value exceeds our buffer size
         //
-        while (mask != 0 && dest != end) {
-            UnsignedIntT const nibble = (value & mask) >> shift;
+        if (digits != total_digits) {
+            value >>= (total_digits - digits) * DigitBits;
+        }
 
-            if (nibble < 10) {
-                *dest++ = static_cast<char>('0' + nibble);
+        // write whole groups of digits from least to most significant, then
+        // take any remaining leading digits from the tail of a final entry
+        //
+        char* ptr = dest + digits;
+        while (ptr - dest >= GroupDigits) {
+            char const* const entry = table + (static_cast<unsigned>(value) & group_mask) * GroupDigits;
+            ptr -= GroupDigits;
+            for (int index = 0; index != GroupDigits; ++index) {
+                ptr[index] = entry[index];
             }
-            else {
-                *dest++ = static_cast<char>(A + nibble - 10);
+            value = static_cast<UnsignedIntT>(value >> group_bits);
+        }
+        if (ptr != dest) {
+            int const remaining = static_cast<int>(ptr - dest);
+            char const* const entry = table + (static_cast<unsigned>(value) & group_mask) * GroupDigits;
+            for (int index = 0; index != remaining; ++index) {
+                dest[index] = entry[GroupDigits - remaining + index];
             }
-
-            shift -= bits_per_nibble;
-            mask >>= bits_per_nibble;
         }
 
-        return dest;
+        return dest + digits;
     }
 
-    template <typename UnsignedIntT>
-    char* detail::to_chars_impl_binary(char* dest, char const* end, UnsignedIntT value) noexcept {
-        static_assert(std::is_unsigned_v<UnsignedIntT>);
+    template <char A>
+    char* detail::to_chars_impl_hex64(char* dest, char const* end, std::uint64_t value) noexcept {
+        if (dest == end) {
+            return dest;
+        }
 
-        // find the initial non-zero bit in the input
+        // shift out the leading zero digits, then generate all 16 digits at
+        // once into scratch, of which only the significant digits are copied
+        // so that nothing past the returned pointer is written
         //
-        int const zeroes = countl_zero(value);
-        UnsignedIntT mask = 1ull << ((sizeof(value) * 8 - zeroes) - 1);
+        int const zero_digits = countl_zero(value) / 4;
+        auto const digits = static_cast<std::size_t>(16 - zero_digits);
+        std::uint64_t const aligned = value << (zero_digits * 4);
 
-        // iterate the bits from MSB to LSB, so that we
-        // can terminate if the buffer becomes full
+        char buffer[16];
+        hex64_digits<A>(aligned, buffer);
+
+        auto const available = static_cast<std::size_t>(end - dest);
+        std::size_t const length = digits < available ? digits : available;
+        std::memcpy(dest, buffer, length);
+        return dest + length;
+    }
+
+    template <char A>
+    void detail::hex64_digits(std::uint64_t value, char* digits) noexcept {
+        // distance from '9' + 1 to the first letter
+        [[maybe_unused]] constexpr char letter_offset = A - '0' - 10;
+
+#if NANOFMT_HAS_SSE2
+        // put the most significant byte first, so that unpacking the high
+        // and low nibbles of each byte yields the digits in output order
         //
-        while (mask != 0 && dest != end) {
-            *dest++ = '0' + ((value & mask) != 0);
-            mask >>= 1;
+        std::uint64_t const swapped = byteswap(value);
+
+        __m128i const bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(&swapped));
+        __m128i const low_mask = _mm_set1_epi8(0x0f);
+        __m128i const high = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+        __m128i const low = _mm_and_si128(bytes, low_mask);
+        __m128i const nibbles = _mm_unpacklo_epi8(high, low);
+
+#    if NANOFMT_HAS_SSSE3
+        __m128i const table = _mm_setr_epi8(
+            '0',
+            '1',
+            '2',
+            '3',
+            '4',
+            '5',
+            '6',
+            '7',
+            '8',
+            '9',
+            A,
+            A + 1,
+            A + 2,
+            A + 3,
+            A + 4,
+            A + 5);
+        __m128i const chars = _mm_shuffle_epi8(table, nibbles);
+#    else
+        __m128i const letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+        __m128i const chars = _mm_add_epi8(
+            _mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+            _mm_and_si128(letters, _mm_set1_epi8(letter_offset)));
+#    endif
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(digits), chars);
+#else
+        // SWAR fallback: spread each 32-bit half so that every nibble
+        // occupies its own byte, then convert all eight bytes at once
+        //
+        for (int half = 0; half != 2; ++half) {
+            std::uint64_t spread = (value >> (32 - half * 32)) & 0xffff'ffffu;
+            spread = (spread | (spread << 16)) & 0x0000'ffff'0000'ffffu;
+            spread = (spread | (spread << 8)) & 0x00ff'00ff'00ff'00ffu;
+            spread = (spread | (spread << 4)) & 0x0f0f'0f0f'0f0f'0f0fu;
+
+            std::uint64_t const letters = ((spread + 0x0606'0606'0606'0606u) >> 4) & 0x0101'0101'0101'0101u;
+            std::uint64_t const chars =
+                spread + 0x3030'3030'3030'3030u + letters * static_cast<std::uint64_t>(letter_offset);
+
+            // byte 0 holds the least significant nibble, which is written last
+            for (int index = 0; index != 8; ++index) {
+                digits[half * 8 + index] = static_cast<char>(chars >> ((7 - index) * 8));
+            }
         }
-
-        return dest;
+#endif
     }
 
-    template <typename UnsignedIntT>
-    char* detail::to_chars_n_round(char* dest, char const* end, UnsignedIntT value, std::size_t count) noexcept {
-        static_assert(std::is_unsigned_v<UnsignedIntT>);
+    char* detail::to_chars_impl_prefix(char* dest, char const* end, int_format fmt, bool nonzero) noexcept {
+        switch (fmt) {
+            case int_format::hex_prefixed:
+                return copy_to_n(dest, end, "0x", 2);
+            case int_format::hex_upper_prefixed:
+                return copy_to_n(dest, end, "0X", 2);
+            case int_format::binary_prefixed:
+                return copy_to_n(dest, end, "0b", 2);
+            case int_format::binary_upper_prefixed:
+                return copy_to_n(dest, end, "0B", 2);
+            case int_format::octal_prefixed:
+                // zero is written as a plain 0, and needs no prefix
+                return nonzero ? put(dest, end, '0') : dest;
+            default:
+                return dest;
+        }
+    }
 
-        if (count == 0) {
-            return dest;
+    template <typename IntegerT>
+    from_chars_result detail::from_chars_impl(
+        char const* first,
+        char const* last,
+        IntegerT& value,
+        int_format fmt) noexcept {
+        using UnsignedT = std::make_unsigned_t<IntegerT>;
+
+        char const* ptr = first;
+
+        bool negative = false;
+        if constexpr (std::is_signed_v<IntegerT>) {
+            if (ptr != last && *ptr == '-') {
+                negative = true;
+                ++ptr;
+            }
         }
 
-        char tmp[significand_max_digits10] = {};
+        ptr = from_chars_prefix(ptr, last, fmt);
+        if (ptr == nullptr) {
+            return {first, from_chars_error::invalid_argument};
+        }
 
-        // FIXME: we could use a much faster to_chars here; e.g. we could
-        // keep this in reversed order, and we know it'll never truncate
+        // parse the magnitude as a 64-bit value, and range check it afterwards
         //
-        size_t const tmp_len = to_chars(tmp, tmp + sizeof tmp, value) - tmp;
+        std::uint64_t magnitude = 0;
+        bool overflow = false;
+        char const* digits_end = ptr;
+        switch (fmt) {
+            case int_format::decimal:
+                digits_end = from_chars_decimal(ptr, last, magnitude, overflow);
+                break;
+            case int_format::hex:
+            case int_format::hex_prefixed:
+            case int_format::hex_upper:
+            case int_format::hex_upper_prefixed:
+                digits_end = from_chars_radix<4>(ptr, last, magnitude, overflow);
+                break;
+            case int_format::binary:
+            case int_format::binary_prefixed:
+            case int_format::binary_upper_prefixed:
+                digits_end = from_chars_radix<1>(ptr, last, magnitude, overflow);
+                break;
+            case int_format::octal:
+            case int_format::octal_prefixed:
+                digits_end = from_chars_radix<3>(ptr, last, magnitude, overflow);
+                break;
+            default:
+                break;
+        }
+
+        if (digits_end == ptr) {
+            return {first, from_chars_error::invalid_argument};
+        }
 
-        // if we have as many or fewer digits as our round position, we're done (nothing
-        // to round from)
+        // negative values may reach one past the positive maximum
         //
-        if (tmp_len <= count) {
-            return copy_to_n(dest, end, tmp, tmp_len);
+        std::uint64_t const limit = static_cast<std::uint64_t>(std::numeric_limits<IntegerT>::max()) + negative;
+        if (overflow || magnitude > limit) {
+            return {digits_end, from_chars_error::result_out_of_range};
         }
 
-        char const remainder_digit = tmp[count];
+        auto const result = static_cast<UnsignedT>(magnitude);
+        value = static_cast<IntegerT>(negative ? static_cast<UnsignedT>(0 - result) : result);
+        return {digits_end, from_chars_error::none};
+    }
+
+    // returns nullptr if a required prefix is missing
+    //
+    char const* detail::from_chars_prefix(char const* first, char const* last, int_format fmt) noexcept {
+        char letter = 0;
+        switch (fmt) {
+            case int_format::hex_prefixed:
+            case int_format::hex_upper_prefixed:
+                letter = 'x';
+                break;
+            case int_format::binary_prefixed:
+            case int_format::binary_upper_prefixed:
+                letter = 'b';
+                break;
+            default:
+                // the octal prefix is just a leading zero, which parses as a digit
+                return first;
+        }
 
-        // if the remainder is less than 1/2 then we have no rounding to do
-        if (remainder_digit < '5') {
-            return copy_to_n(dest, end, tmp, count);
+        // either case of prefix is accepted, as with hex digits
+        //
+        if (last - first < 2 || first[0] != '0' || (first[1] | 0x20) != letter) {
+            return nullptr;
         }
+        return first + 2;
+    }
 
-        // if our remainder is exactly 1/2 we round to nearest even;
-        // the following loop handles rounding _up_, so we only need
-        // to handle the special case of rounding _down_ here
+    char const* detail::from_chars_decimal(
+        char const* first,
+        char const* last,
+        std::uint64_t& value,
+        bool& overflow) noexcept {
+        // 19 digits always fit in 64 bits, and a 20th may
         //
-        // we identify "exactly 1/2" as having exactly one remaining
-        // digit equal to 5; this only works because we have dragonbox
-        // strip trialing zeroes!
+        constexpr int safe_digits = 19;
+
+        // leading zeroes do not count towards the digit limit
+        //
+        while (first != last && *first == '0') {
+            ++first;
+        }
+
+        std::uint64_t result = 0;
+        int digits = 0;
+
+        // consume eight digits per step while the input has them
         //
-        if (remainder_digit == '5' && tmp_len - 1 == count) {
-            char const last_digit = tmp[count - 1];
-            bool const is_even = ((last_digit - '0') & 1) == 0;
-            if (is_even) {
-                return copy_to_n(dest, end, tmp, count);
+        while (last - first >= 8 && digits + 8 <= safe_digits) {
+            std::uint64_t const chars = load_le64(first);
+            if (!is_eight_digits(chars)) {
+                break;
             }
+            result = result * 100'000'000u + parse_eight_digits(chars);
+            first += 8;
+            digits += 8;
         }
 
-        // we're rounding up; walk backwards and round up characters so long
-        // as we have a 9 to round up, and stop otherwise
+        // finish any remaining digits one at a time; digits past the limit are
+        // still consumed, so that the result points past the whole number
         //
-        char* ptr = tmp + count;
-        while (ptr-- > tmp) {
-            if (*ptr == '9') {
-                *ptr = '0';
+        constexpr std::uint64_t max_value = ~std::uint64_t{0};
+        for (; first != last; ++first, ++digits) {
+            unsigned const digit = static_cast<unsigned char>(*first) - unsigned{'0'};
+            if (digit > 9) {
+                break;
+            }
+            if (digits < safe_digits || (digits == safe_digits && result <= (max_value - digit) / 10)) {
+                result = result * 10 + digit;
+            }
+            else {
+                overflow = true;
+            }
+        }
+
+        value = result;
+        return first;
+    }
+
+    template <int DigitBits>
+    char const* detail::from_chars_radix(
+        char const* first,
+        char const* last,
+        std::uint64_t& value,
+        bool& overflow) noexcept {
+        constexpr unsigned base = 1u << DigitBits;
+
+        std::uint64_t result = 0;
+        for (; first != last; ++first) {
+            unsigned const digit = digit_values[*first];
+            if (digit >= base) {
+                break;
+            }
+            if ((result >> (64 - DigitBits)) != 0) {
+                overflow = true;
                 continue;
             }
-            ++*ptr;
-            break;
+            result = (result << DigitBits) | digit;
         }
 
-        return copy_to_n(dest, end, tmp, count);
+        value = result;
+        return first;
     }
 
-    template <char E, bool TrailingZeroes, typename CarrierT>
-    char* detail::to_chars_impl_scientific(
-        char* dest,
-        char const* end,
-        CarrierT significand,
+    template <typename UnsignedIntT>
+    char* detail::to_chars_impl_decimal_padded(char* dest, char const* end, UnsignedIntT value, int width) noexcept {
+        static_assert(std::is_unsigned_v<UnsignedIntT>);
+
+        // writes exactly width digits, with leading zeroes as needed; a zero
+        // width writes nothing at all, even for a zero value
+        //
+        if (width <= 0) {
+            return dest;
+        }
+
+        int const digits = count_digits(value);
+        if (width > digits) {
+            dest = fill_n(dest, end, '0', static_cast<size_t>(width - digits));
+        }
+        return to_chars_impl_decimal(dest, end, value);
+    }
+
+    template <typename CarrierT>
+    void detail::round_significand(CarrierT& significand, int& exponent, int place) noexcept {
+        static_assert(std::is_unsigned_v<CarrierT>);
+
+        // round significand * 10^exponent to a multiple of 10^place, with
+        // ties to even; the division and remainder are exact, so a tie is
+        // recognized without depending on trailing zeroes having been removed
+        //
+        int const drop = place - exponent;
+        if (drop <= 0) {
+            return;
+        }
+
+        int const digits = count_digits(significand);
+        exponent = place;
+
+        // the value is less than a tenth of the rounding unit
+        //
+        if (drop > digits) {
+            significand = 0;
+            return;
+        }
+
+        CarrierT quotient = 0;
+        CarrierT remainder = significand;
+        if (drop < digits) {
+            auto const divisor = static_cast<CarrierT>(pow10_table[drop]);
+            quotient = significand / divisor;
+            remainder = significand - quotient * divisor;
+        }
+
+        // a round up may carry into a new leading digit, e.g. 999 -> 100
+        //
+        std::uint64_t const half = 5 * pow10_table[drop - 1];
+        if (remainder > half || (remainder == half && (quotient & 1u) != 0)) {
+            ++quotient;
+        }
+
+        significand = quotient;
+    }
+
+    template <char E, bool TrailingZeroes, typename CarrierT>
+    char* detail::to_chars_impl_scientific(
+        char* dest,
+        char const* end,
+        CarrierT significand,
         int exponent,
         int precision) noexcept {
         static_assert(std::is_unsigned_v<CarrierT>);
 
-        // generate significand digits, with truncation/rounding when appropriate
+        // round to precision + 1 significant digits; a carry into a new
+        // leading digit leaves a trailing zero that is shifted into the
+        // exponent, e.g. 9.96 -> 10.0 -> 1.0e+01
         //
-        char digits[significand_max_digits10] = {};
-        char const* const digits_end = precision < 0
-            ? to_chars(digits, digits + sizeof digits, significand)
-            : to_chars_n_round(digits, digits + sizeof digits, significand, precision + 1);
-        int const digits_count = static_cast<int>(digits_end - digits);
+        if (precision >= 0) {
+            round_significand(significand, exponent, exponent + count_digits(significand) - (precision + 1));
+            if (count_digits(significand) > precision + 1) {
+                significand /= 10u;
+                ++exponent;
+            }
+        }
 
         // calculate our adjusted exponent, which shifts the decimal point to be just after
-        // the most significant digit (based on the actual significand, not the truncated/
-        // rounded version)
+        // the most significant digit
+        //
+        int const sig_digits = count_digits(significand);
+        int const adjusted_exp = exponent + sig_digits - 1;
+
+        // split off the most significant digit; the remaining digits are the
+        // fractional part, which may have leading zeroes
         //
-        int const adjusted_exp = exponent + count_digits(significand) - 1;
-        auto const absolute_exp = abs(adjusted_exp);
+        auto const leading_divisor = static_cast<CarrierT>(pow10_table[sig_digits - 1]);
+        CarrierT const leading = significand / leading_divisor;
+        CarrierT const fract = significand - leading * leading_divisor;
 
         // calculate the length of our fractional portion after the decimal point.
         // if a precision is provided, that specifies the precise number of digits
         // in the fractional portion; otherwise, it's just whatever is "leftover"
         // from the significand
         //
-        int const fract_digits = precision < 0 ? digits_count - 1 : precision;
+        int const fract_available = sig_digits - 1;
+        int const fract_digits = precision < 0 ? fract_available : precision;
 
         // write most significant digit
-        dest = put(dest, end, digits[0]);
+        dest = put(dest, end, static_cast<char>('0' + leading));
 
         // write fractional part, if any
-        if (fract_digits > 0) {
+        if (fract_digits > 0 && (TrailingZeroes || fract_available > 0)) {
             dest = put(dest, end, '.');
-
-            int const fract_available = digits_count - 1;
-            int const fract_buffer_size = min<int>(fract_available, fract_digits);
-            dest = copy_to_n(dest, end, digits + 1, fract_buffer_size);
+            dest = to_chars_impl_decimal_padded(dest, end, fract, fract_available);
 
             // fill in any trailing zeroes only if our mode allows it; this is effectively
             // always going to be the precision minus the number of fractional digits pulled
             // from the significand
             //
             if constexpr (TrailingZeroes) {
-                dest = fill_n(dest, end, '0', static_cast<size_t>(fract_digits) - fract_buffer_size);
+                dest = fill_n(dest, end, '0', static_cast<size_t>(fract_digits - fract_available));
             }
         }
 
-        // write exponent, format [eE][+-][d]dd (zero-padded if exponent if less than two digits)
-        //
-        dest = put(dest, end, E);
-        dest = put(dest, end, adjusted_exp < 0 ? '-' : '+');
-        if (absolute_exp < 10) {
-            dest = put(dest, end, '0');
-        }
-        return to_chars(dest, end, absolute_exp);
+        return to_chars_impl_exponent<E>(dest, end, adjusted_exp);
     }
 
     template <bool TrailingZeroes, typename CarrierT>
@@ -435,74 +1155,50 @@ namespace NANOFMT_NS {
         int precision) noexcept {
         static_assert(std::is_unsigned_v<CarrierT>);
 
-        int const sig_digits = count_digits(significand);
-
-        // find the location of the decimmal point
+        // round away any digits past the precision; this may leave nothing
+        // but zero, or carry into a new integer digit, e.g. 9.96 -> 10.0
         //
-        int const decimal_pos = sig_digits + exponent;
-
-        // in the case that the decimal position is outside our
-        // precision, we're just going to print zeroes and don't
-        // even need to turn our significand into decimals
-        //
-        if (precision >= 0 && -decimal_pos > precision) {
-            // we will only display zeroes due to truncation
-            if constexpr (TrailingZeroes) {
-                if (precision > 0) {
-                    dest = copy_to_n(dest, end, "0.", 2);
-                    return fill_n(dest, end, '0', precision);
-                }
-            }
-            return put(dest, end, '0');
+        if (precision >= 0) {
+            round_significand(significand, exponent, -precision);
         }
 
-        // calculate how many of the significant digits _might_ be visible,
-        // and how many _are_ visible
-        int const max_visible_digits = precision < 0 ? sig_digits : decimal_pos + precision;
-        int const visible_digits = min<int>(sig_digits, max_visible_digits);
-
-        // calculate the length of the integer (pre-decimal) part
-        //
-        int const integer_length = max<int>(decimal_pos, 0);
-
-        // calculate the visible integer (pre-decimal) and fractional (post-decimal) digits
-        // of the significand
+        // number of digits after the decimal point taken from the significand,
+        // including any zeroes between the decimal point and the significand
         //
-        int const integer_digits = min<int>(visible_digits, integer_length);
-        int const fract_digits = visible_digits - integer_digits;
-
-        // generate significand digits; we know the full buffer will always be used since
-        // max_visible_digits is always _at least_ the actual digits we will actually display
-        //
-        char digits[significand_max_digits10];
-        to_chars_n_round(digits, digits + sizeof digits, significand, visible_digits);
+        int const fract_digits = max<int>(-exponent, 0);
 
         // write the integer portion of the significand and enough zeroes to reach
         // the decimal point; if there is no integer portion of the significand,
         // just write a zero
-        if (decimal_pos > 0) {
-            dest = copy_to_n(dest, end, digits, integer_digits);
-            if (integer_length > integer_digits) {
-                dest = fill_n(dest, end, '0', static_cast<size_t>(integer_length) - integer_digits);
-            }
+        //
+        CarrierT fract = 0;
+        if (significand == 0) {
+            dest = put(dest, end, '0');
+        }
+        else if (exponent >= 0) {
+            dest = to_chars_impl_decimal(dest, end, significand);
+            dest = fill_n(dest, end, '0', static_cast<size_t>(exponent));
+        }
+        else if (fract_digits < count_digits(significand)) {
+            auto const divisor = static_cast<CarrierT>(pow10_table[fract_digits]);
+            CarrierT const integer = significand / divisor;
+            fract = significand - integer * divisor;
+            dest = to_chars_impl_decimal(dest, end, integer);
         }
         else {
+            fract = significand;
             dest = put(dest, end, '0');
         }
 
         // write the fractional portion of the signifand and any appropriate trailing zeroes
         //
-        if (fract_digits > 0 || (precision > 0 && TrailingZeroes)) {
-            int const fract_offset = max<int>(-decimal_pos, 0);
-
+        int const fract_shown = significand != 0 ? fract_digits : 0;
+        if (fract_shown > 0 || (precision > 0 && TrailingZeroes)) {
             dest = put(dest, end, '.');
-            dest = fill_n(dest, end, '0', fract_offset);
-            dest = copy_to_n(dest, end, digits + integer_digits, fract_digits);
+            dest = to_chars_impl_decimal_padded(dest, end, fract, fract_shown);
 
             if constexpr (TrailingZeroes) {
-                int const fract_length_unused = fract_digits + fract_offset;
-                int const fract_tail_zeroes = max<int>(precision - fract_length_unused, 0);
-                dest = fill_n(dest, end, '0', fract_tail_zeroes);
+                dest = fill_n(dest, end, '0', static_cast<size_t>(max<int>(precision - fract_shown, 0)));
             }
         }
 
@@ -516,8 +1212,6 @@ namespace NANOFMT_NS {
         CarrierT significand,
         int exponent,
         int precision) noexcept {
-        int const sig_digits = count_digits(significand);
-
         // C11 spec (see also https://en.cppreference.com/w/c/io/fprintf)
         //
         // For the g conversion style conversion with style e or f will be performed.
@@ -533,15 +1227,563 @@ namespace NANOFMT_NS {
         //
 
         int const P = (precision < 0) ? 6 : (precision == 0) ? 1 : precision;
-        int const X = exponent + sig_digits - 1;
+
+        // X is the exponent after rounding to P digits, so round first; the
+        // chosen style then has nothing left to round, and trailing zeroes
+        // left behind by rounding are not displayed
+        //
+        round_significand(significand, exponent, exponent + count_digits(significand) - P);
+        while (significand != 0 && significand % 10u == 0) {
+            significand /= 10u;
+            ++exponent;
+        }
+
+        int const X = exponent + count_digits(significand) - 1;
 
         if (P > X && X >= -4) {
-            return to_chars_impl_fixed</*TrailingZeroes=*/false>(dest, end, significand, exponent, P - 1 - exponent);
+            return to_chars_impl_fixed</*TrailingZeroes=*/false>(dest, end, significand, exponent, P - 1 - X);
         }
         return to_chars_impl_scientific<E, /*TrailingZeroes=*/false>(dest, end, significand, exponent, P - 1);
     }
 
+    template <char E, bool TrailingZeroes>
+    char* detail::to_chars_impl_scientific_digits(
+        char* dest,
+        char const* end,
+        char const* digits,
+        int count,
+        int exponent,
+        int precision) noexcept {
+        // the digits are already rounded to at most precision + 1 digits, and
+        // have no leading zeroes
+        //
+        int const adjusted_exp = exponent + count - 1;
+        int const fract_available = count - 1;
+
+        dest = put(dest, end, digits[0]);
+
+        if (precision > 0 && (TrailingZeroes || fract_available > 0)) {
+            dest = put(dest, end, '.');
+            dest = copy_to_n(dest, end, digits + 1, fract_available);
+
+            if constexpr (TrailingZeroes) {
+                dest = fill_n(dest, end, '0', static_cast<size_t>(precision - fract_available));
+            }
+        }
+
+        return to_chars_impl_exponent<E>(dest, end, adjusted_exp);
+    }
+
+    template <bool TrailingZeroes>
+    char* detail::to_chars_impl_fixed_digits(
+        char* dest,
+        char const* end,
+        char const* digits,
+        int count,
+        int exponent,
+        int precision) noexcept {
+        // the digits are already rounded to the precision, and have no leading
+        // zeroes; a count of zero is a value that rounded to zero
+        //
+        int const decimal_pos = count + exponent;
+        int const integer_digits = count != 0 ? min<int>(max<int>(decimal_pos, 0), count) : 0;
+        int const fract_digits = count - integer_digits;
+        int const fract_offset = max<int>(-decimal_pos, 0);
+
+        if (integer_digits != 0) {
+            dest = copy_to_n(dest, end, digits, integer_digits);
+            dest = fill_n(dest, end, '0', static_cast<size_t>(max<int>(exponent, 0)));
+        }
+        else {
+            dest = put(dest, end, '0');
+        }
+
+        int const fract_shown = fract_digits != 0 ? fract_offset + fract_digits : 0;
+        if (fract_shown > 0 || (precision > 0 && TrailingZeroes)) {
+            dest = put(dest, end, '.');
+            dest = fill_n(dest, end, '0', static_cast<size_t>(fract_digits != 0 ? fract_offset : 0));
+            dest = copy_to_n(dest, end, digits + integer_digits, fract_digits);
+
+            if constexpr (TrailingZeroes) {
+                dest = fill_n(dest, end, '0', static_cast<size_t>(max<int>(precision - fract_shown, 0)));
+            }
+        }
+
+        return dest;
+    }
+
+    template <char E>
+    char* detail::to_chars_impl_exponent(char* dest, char const* end, int exponent) noexcept {
+        // format [eE][+-][d]dd (zero-padded if exponent if less than two digits)
+        //
+        auto const absolute_exp = abs(exponent);
+
+        dest = put(dest, end, E);
+        dest = put(dest, end, exponent < 0 ? '-' : '+');
+        if (absolute_exp < 10) {
+            dest = put(dest, end, '0');
+        }
+        return to_chars(dest, end, absolute_exp);
+    }
+
 #if NANOFMT_FLOAT
+    // values that are exact integers, or exact fractions with a short decimal
+    // expansion, already have that expansion as their shortest round-trip
+    // representation; such values skip dragonbox entirely
+    //
+    template <typename CarrierT, typename FloatT>
+    bool detail::to_decimal_exact(FloatT value, CarrierT& significand, int& exponent) noexcept {
+        static_assert(sizeof(CarrierT) == sizeof(FloatT));
+
+        constexpr int mantissa_bits = std::numeric_limits<FloatT>::digits - 1;
+        constexpr int exponent_mask = (1 << (sizeof(FloatT) * 8 - 1 - mantissa_bits)) - 1;
+        constexpr int exponent_bias = std::numeric_limits<FloatT>::max_exponent - 1 + mantissa_bits;
+
+        // any decimal with fewer digits than this differs from the value by
+        // more than half an ulp, so it cannot be a shorter representation
+        constexpr int max_fraction_digits = std::numeric_limits<FloatT>::digits10;
+
+        // 5^k for each k where 5^k has at most max_fraction_digits digits
+        constexpr std::uint64_t pow5_table[] = {
+            1ull,
+            5ull,
+            25ull,
+            125ull,
+            625ull,
+            3'125ull,
+            15'625ull,
+            78'125ull,
+            390'625ull,
+            1'953'125ull,
+            9'765'625ull,
+            48'828'125ull,
+            244'140'625ull,
+            1'220'703'125ull,
+            6'103'515'625ull,
+            30'517'578'125ull,
+            152'587'890'625ull,
+            762'939'453'125ull,
+            3'814'697'265'625ull,
+            19'073'486'328'125ull,
+            95'367'431'640'625ull,
+            476'837'158'203'125ull,
+        };
+
+        CarrierT bits = 0;
+        std::memcpy(&bits, &value, sizeof bits);
+
+        int const biased_exponent = static_cast<int>(bits >> mantissa_bits) & exponent_mask;
+
+        // subnormals are left to dragonbox
+        if (biased_exponent == 0) {
+            return false;
+        }
+
+        CarrierT mantissa = (bits & ((CarrierT{1} << mantissa_bits) - 1)) | (CarrierT{1} << mantissa_bits);
+        int binary_exponent = biased_exponent - exponent_bias;
+
+        int const trailing_bits = countr_zero(mantissa);
+        mantissa >>= trailing_bits;
+        binary_exponent += trailing_bits;
+
+        if (binary_exponent >= 0) {
+            // integers whose magnitude is below 2^(mantissa_bits + 1) are exact,
+            // and adjacent values are no more than one apart
+            //
+            int const mantissa_width = static_cast<int>(sizeof(CarrierT) * 8) - countl_zero(mantissa);
+            if (mantissa_width + binary_exponent > mantissa_bits + 1) {
+                return false;
+            }
+
+            CarrierT integer = static_cast<CarrierT>(mantissa << binary_exponent);
+            int zeroes = 0;
+            while (integer % 10u == 0) {
+                integer /= 10u;
+                ++zeroes;
+            }
+
+            significand = integer;
+            exponent = zeroes;
+            return true;
+        }
+
+        // m * 2^-k is exactly m * 5^k * 10^-k; m is odd, so the product has
+        // no trailing decimal zeroes to remove
+        //
+        int const fraction_digits = -binary_exponent;
+        if (fraction_digits >= static_cast<int>(sizeof pow5_table / sizeof pow5_table[0])) {
+            return false;
+        }
+
+        std::uint64_t const pow5 = pow5_table[fraction_digits];
+        std::uint64_t const max_significand = pow10_table[max_fraction_digits] - 1;
+        if (mantissa > max_significand / pow5) {
+            return false;
+        }
+
+        significand = static_cast<CarrierT>(mantissa * pow5);
+        exponent = binary_exponent;
+        return true;
+    }
+
+    // dropping digits from the shortest round-trip digits gives the correctly
+    // rounded value, except on an exact tie where the value may lie on either
+    // side; any rounding boundary strictly between the shortest digits and the
+    // value would itself be a shorter or closer representation. keeping all of
+    // the shortest digits, or padding them with zeroes, is only correct up to
+    // the number of digits the format guarantees, which is fewer for subnormals
+    //
+    template <typename FloatT, typename CarrierT>
+    bool detail::needs_exact_digits(
+        FloatT value,
+        float_format fmt,
+        CarrierT significand,
+        int exponent,
+        int precision) noexcept {
+        int const sig_digits = count_digits(significand);
+
+        int requested = 0;
+        switch (fmt) {
+            case float_format::fixed:
+                if (precision < 0) {
+                    return false;
+                }
+                requested = sig_digits + exponent + precision;
+                break;
+            case float_format::scientific:
+            case float_format::scientific_upper:
+                if (precision < 0) {
+                    return false;
+                }
+                requested = precision + 1;
+                break;
+            case float_format::general:
+            case float_format::general_upper:
+                requested = (precision < 0) ? 6 : (precision == 0) ? 1 : precision;
+                break;
+            default:
+                return false;
+        }
+
+        if (requested >= sig_digits) {
+            return requested > std::numeric_limits<FloatT>::digits10 ||
+                std::fabs(value) < std::numeric_limits<FloatT>::min();
+        }
+
+        int const drop = sig_digits - requested;
+        if (drop > sig_digits) {
+            return false;
+        }
+        return std::uint64_t{significand} % pow10_table[drop] == 5 * pow10_table[drop - 1];
+    }
+
+    template <typename CarrierT, typename FloatT>
+    char* detail::to_chars_impl_exact(
+        char* dest,
+        char const* end,
+        FloatT value,
+        float_format fmt,
+        int precision,
+        int adjusted_exp) noexcept {
+        // a value has at most digits10 + 1 integer digits when it has any
+        // fractional bits at all, and at most max_fraction_digits fractional
+        // digits; larger values are whole numbers of at most max_exponent10 + 1
+        // digits
+        //
+        constexpr int max_fraction_digits = std::numeric_limits<FloatT>::digits - std::numeric_limits<FloatT>::min_exponent;
+        constexpr int max_digits = std::numeric_limits<FloatT>::digits10 + 1 + max_fraction_digits;
+
+        char digits[max_digits];
+        int exponent = 0;
+
+        switch (fmt) {
+            case float_format::fixed: {
+                char const* const digits_end =
+                    to_digits_exact<CarrierT>(digits, digits + sizeof digits, value, -precision, exponent);
+                int const count = static_cast<int>(digits_end - digits);
+                return to_chars_impl_fixed_digits(dest, end, digits, count, exponent, precision);
+            }
+            case float_format::scientific:
+            case float_format::scientific_upper: {
+                char const* const digits_end = to_digits_exact_significant<CarrierT>(
+                    digits,
+                    digits + sizeof digits,
+                    value,
+                    precision + 1,
+                    adjusted_exp,
+                    exponent);
+                int const count = static_cast<int>(digits_end - digits);
+                return fmt == float_format::scientific_upper
+                    ? to_chars_impl_scientific_digits<'E'>(dest, end, digits, count, exponent, precision)
+                    : to_chars_impl_scientific_digits<'e'>(dest, end, digits, count, exponent, precision);
+            }
+            case float_format::general:
+            case float_format::general_upper: {
+                // see to_chars_impl_general
+                //
+                int const P = (precision < 0) ? 6 : (precision == 0) ? 1 : precision;
+
+                char const* digits_end =
+                    to_digits_exact_significant<CarrierT>(digits, digits + sizeof digits, value, P, adjusted_exp, exponent);
+                while (digits_end[-1] == '0') {
+                    --digits_end;
+                    ++exponent;
+                }
+                int const count = static_cast<int>(digits_end - digits);
+                int const X = exponent + count - 1;
+
+                if (P > X && X >= -4) {
+                    return to_chars_impl_fixed_digits</*TrailingZeroes=*/false>(
+                        dest,
+                        end,
+                        digits,
+                        count,
+                        exponent,
+                        P - 1 - X);
+                }
+                return fmt == float_format::general_upper
+                    ? to_chars_impl_scientific_digits<'E', /*TrailingZeroes=*/false>(
+                          dest,
+                          end,
+                          digits,
+                          count,
+                          exponent,
+                          P - 1)
+                    : to_chars_impl_scientific_digits<'e', /*TrailingZeroes=*/false>(
+                          dest,
+                          end,
+                          digits,
+                          count,
+                          exponent,
+                          P - 1);
+            }
+            default:
+                return dest;
+        }
+    }
+
+    // writes the exact decimal digits of value, rounded to a multiple of
+    // 10^place with ties to even, and without leading zeroes; exponent is set
+    // to the place of the last digit written, which is above the requested
+    // place when all further digits would be zero
+    //
+    template <typename CarrierT, typename FloatT>
+    char* detail::to_digits_exact(char* dest, char const* end, FloatT value, int place, int& exponent) noexcept {
+        static_assert(sizeof(CarrierT) == sizeof(FloatT));
+
+        constexpr int mantissa_bits = std::numeric_limits<FloatT>::digits - 1;
+        constexpr int exponent_mask = (1 << (sizeof(FloatT) * 8 - 1 - mantissa_bits)) - 1;
+        constexpr int exponent_bias = std::numeric_limits<FloatT>::max_exponent - 1 + mantissa_bits;
+
+        // the scaled value is largest either for the largest finite value, or
+        // for the smallest subnormal scaled by 10^max_fraction_digits, where
+        // log2(10) is bounded by 10/3
+        //
+        constexpr int max_fraction_digits = std::numeric_limits<FloatT>::digits - std::numeric_limits<FloatT>::min_exponent;
+        constexpr int max_bits = max<int>(
+            std::numeric_limits<FloatT>::max_exponent,
+            std::numeric_limits<FloatT>::digits + (max_fraction_digits * 10 + 2) / 3);
+        constexpr int max_limbs = max_bits / 32 + 2;
+
+        CarrierT bits = 0;
+        std::memcpy(&bits, &value, sizeof bits);
+
+        int const biased_exponent = static_cast<int>(bits >> mantissa_bits) & exponent_mask;
+        CarrierT mantissa = bits & ((CarrierT{1} << mantissa_bits) - 1);
+        int binary_exponent = 1 - exponent_bias;
+        if (biased_exponent != 0) {
+            mantissa |= CarrierT{1} << mantissa_bits;
+            binary_exponent = biased_exponent - exponent_bias;
+        }
+
+        if (mantissa == 0) {
+            exponent = place;
+            return dest;
+        }
+
+        int const trailing_bits = countr_zero(mantissa);
+        mantissa >>= trailing_bits;
+        binary_exponent += trailing_bits;
+
+        // m * 2^-k has exactly k fractional digits, so there is nothing to
+        // round below that place
+        //
+        place = max<int>(place, min<int>(binary_exponent, 0));
+        exponent = place;
+
+        // scale to m * 2^e * 10^-place, which is an integer after dividing
+        // out any negative power of two
+        //
+        bigint<max_limbs> number{mantissa};
+        if (binary_exponent > 0) {
+            number.shift_left(binary_exponent);
+        }
+        for (int scale = -place; scale > 0; scale -= 9) {
+            number.multiply(static_cast<std::uint32_t>(pow10_table[min<int>(scale, 9)]));
+        }
+
+        bool half = false;
+        bool sticky = false;
+        if (binary_exponent < 0) {
+            half = number.bit(-binary_exponent - 1);
+            sticky = number.any_below(-binary_exponent - 1);
+            number.shift_right(-binary_exponent);
+        }
+        bool round_up = half && (sticky || number.is_odd());
+
+        // a positive place divides out whole digits; the last digit divided
+        // out decides the rounding, and everything below it only breaks ties
+        //
+        if (place > 0) {
+            sticky = sticky || half;
+            for (int scale = place - 1; scale > 0; scale -= 9) {
+                sticky = number.divide(static_cast<std::uint32_t>(pow10_table[min<int>(scale, 9)])) != 0 || sticky;
+            }
+            std::uint32_t const digit = number.divide(10);
+            round_up = digit > 5 || (digit == 5 && (sticky || number.is_odd()));
+        }
+
+        if (round_up) {
+            number.add(1);
+        }
+
+        // peel off nine digits at a time, from least to most significant
+        //
+        std::uint32_t chunks[max_bits / 29 + 1] = {};
+        int chunk_count = 0;
+        while (!number.is_zero()) {
+            chunks[chunk_count++] = number.divide(1'000'000'000);
+        }
+
+        if (chunk_count == 0) {
+            return dest;
+        }
+
+        dest = to_chars_impl_decimal(dest, end, chunks[chunk_count - 1]);
+        for (int index = chunk_count - 1; index-- != 0;) {
+            dest = to_chars_impl_decimal_padded(dest, end, chunks[index], 9);
+        }
+        return dest;
+    }
+
+    // writes the exact decimal digits of value rounded to the given number of
+    // significant digits; adjusted_exp is the decimal exponent of the shortest
+    // representation, which may be one above the exponent of the exact value,
+    // e.g. for a value just below a power of ten
+    //
+    template <typename CarrierT, typename FloatT>
+    char* detail::to_digits_exact_significant(
+        char* dest,
+        char const* end,
+        FloatT value,
+        int significant,
+        int adjusted_exp,
+        int& exponent) noexcept {
+        char* digits_end = to_digits_exact<CarrierT>(dest, end, value, adjusted_exp + 1 - significant, exponent);
+        if (exponent + static_cast<int>(digits_end - dest) - 1 < adjusted_exp) {
+            --adjusted_exp;
+            digits_end = to_digits_exact<CarrierT>(dest, end, value, adjusted_exp + 1 - significant, exponent);
+        }
+
+        // rounding up may carry into a new leading digit, e.g. 9.96 -> 10.0,
+        // leaving one digit too many, which is always a zero
+        //
+        if (digits_end - dest > significant) {
+            --digits_end;
+            ++exponent;
+        }
+        return digits_end;
+    }
+
+    template <char P, typename CarrierT, typename FloatT>
+    char* detail::to_chars_impl_hex(char* dest, char const* end, FloatT value, int precision) noexcept {
+        static_assert(sizeof(CarrierT) == sizeof(FloatT));
+
+        constexpr int mantissa_bits = std::numeric_limits<FloatT>::digits - 1;
+        constexpr int exponent_mask = (1 << (sizeof(FloatT) * 8 - 1 - mantissa_bits)) - 1;
+        constexpr int exponent_bias = std::numeric_limits<FloatT>::max_exponent - 1;
+
+        // the fraction is padded on the right to a whole number of hex digits,
+        // e.g. float's 23 bits of mantissa become six digits
+        //
+        constexpr int fraction_digits = (mantissa_bits + 3) / 4;
+        constexpr int fraction_shift = fraction_digits * 4 - mantissa_bits;
+
+        constexpr char A = P == 'P' ? 'A' : 'a';
+
+        CarrierT bits = 0;
+        std::memcpy(&bits, &value, sizeof bits);
+
+        int const biased_exponent = static_cast<int>(bits >> mantissa_bits) & exponent_mask;
+        CarrierT fraction = static_cast<CarrierT>((bits & ((CarrierT{1} << mantissa_bits) - 1)) << fraction_shift);
+
+        // normal values have an implicit leading 1; subnormals are written
+        // with a leading 0 and the minimum exponent, and zero as 0p+0
+        //
+        unsigned leading = biased_exponent != 0;
+        int exponent = 0;
+        if (biased_exponent != 0) {
+            exponent = biased_exponent - exponent_bias;
+        }
+        else if (fraction != 0) {
+            exponent = 1 - exponent_bias;
+        }
+
+        // the number of fraction digits to take from the left of fraction
+        int digits = fraction_digits;
+        if (precision < 0) {
+            // shortest exact representation; trailing zero digits are dropped
+            digits = fraction != 0 ? fraction_digits - countr_zero(fraction) / 4 : 0;
+        }
+        else if (precision < fraction_digits) {
+            // round half to even on the dropped bits; a carry out of the
+            // fraction propagates into the leading digit, e.g. 1.f -> 2
+            //
+            int const dropped_bits = (fraction_digits - precision) * 4;
+            CarrierT const significand = static_cast<CarrierT>(CarrierT{leading} << (fraction_digits * 4)) | fraction;
+            CarrierT const remainder = significand & ((CarrierT{1} << dropped_bits) - 1);
+            CarrierT const half = CarrierT{1} << (dropped_bits - 1);
+
+            CarrierT rounded = significand >> dropped_bits;
+            if (remainder > half || (remainder == half && (rounded & 1) != 0)) {
+                ++rounded;
+            }
+
+            leading = static_cast<unsigned>(rounded >> (precision * 4));
+            fraction = static_cast<CarrierT>(rounded << dropped_bits);
+            digits = precision;
+        }
+
+        // [-]h.hhhp[+-]d, where the leading sign has already been written;
+        // the fraction digits are the low digits of a 64-bit hex conversion
+        //
+        char buffer[16] = {};
+        hex64_digits<A>(fraction, buffer);
+
+        char* const first = buffer + sizeof buffer - fraction_digits - 2;
+        first[0] = static_cast<char>('0' + leading);
+        first[1] = '.';
+
+        // copy only the digits we want, so that nothing past the returned
+        // pointer is written
+        //
+        std::size_t const length = digits > 0 ? 2 + digits : 1;
+        auto const available = static_cast<std::size_t>(end - dest);
+        std::size_t const copied = length < available ? length : available;
+        if (copied != 0) {
+            std::memcpy(dest, first, copied);
+            dest += copied;
+        }
+
+        if (precision > digits) {
+            dest = fill_n(dest, end, '0', static_cast<size_t>(precision - digits));
+        }
+
+        dest = put(dest, end, P);
+        dest = put(dest, end, exponent < 0 ? '-' : '+');
+        return to_chars(dest, end, abs(exponent));
+    }
+
     char* detail::to_chars_impl_nonfinite(
         char* dest,
         char const* end,
@@ -556,5 +1798,476 @@ namespace NANOFMT_NS {
         }
         return copy_to(dest, end, upper ? "NAN" : "nan");
     }
+
+    template <typename CarrierT, typename FloatT>
+    from_chars_result detail::from_chars_impl(
+        char const* first,
+        char const* last,
+        FloatT& value,
+        float_format fmt) noexcept {
+        static_assert(sizeof(CarrierT) == sizeof(FloatT));
+
+        constexpr bool is_double = sizeof(FloatT) == 8;
+        constexpr int mantissa_bits = std::numeric_limits<FloatT>::digits - 1;
+        constexpr CarrierT infinity_bits = CarrierT{2 * std::numeric_limits<FloatT>::max_exponent - 1}
+            << mantissa_bits;
+
+        // w * 10^q is zero for any 64-bit w when q is below the smallest
+        // power, and is infinite for any non-zero w above the largest
+        //
+        constexpr int smallest_power10 = is_double ? -342 : -64;
+        constexpr int largest_power10 = std::numeric_limits<FloatT>::max_exponent10;
+
+        // the dragonbox cache has no entries for smaller powers
+        //
+        constexpr int smallest_cached_power10 = -292;
+
+        // largest power of ten that is exactly representable
+        //
+        constexpr int max_exact_power10 = is_double ? 22 : 10;
+        constexpr double exact_powers10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+        // the upper case variants parse the same as the lower case ones
+        //
+        auto const flags = static_cast<unsigned>(fmt);
+        if ((flags & static_cast<unsigned>(float_format::hex)) != 0) {
+            return {first, from_chars_error::invalid_argument};
+        }
+        bool const allow_exponent = (flags & static_cast<unsigned>(float_format::scientific)) != 0;
+        bool const require_exponent = allow_exponent && (flags & static_cast<unsigned>(float_format::fixed)) == 0;
+
+        char const* ptr = first;
+
+        bool const negative = ptr != last && *ptr == '-';
+        ptr += negative;
+
+        auto const finish = [&](CarrierT bits, char const* end) noexcept -> from_chars_result {
+            FloatT result;
+            std::memcpy(&result, &bits, sizeof result);
+            value = negative ? -result : result;
+            return {end, from_chars_error::none};
+        };
+
+        bool infinite = false;
+        if (char const* const nonfinite_end = from_chars_nonfinite(ptr, last, infinite); nonfinite_end != nullptr) {
+            value = infinite ? std::numeric_limits<FloatT>::infinity() : std::numeric_limits<FloatT>::quiet_NaN();
+            value = negative ? -value : value;
+            return {nonfinite_end, from_chars_error::none};
+        }
+
+        // the first 19 significant digits are accumulated into a 64-bit
+        // significand, which suffices for every shortest representation
+        //
+        decimal_digits digits;
+        std::uint64_t significand = 0;
+        int significand_digits = 0;
+        int dropped = 0;
+        bool truncated = false;
+
+        digits.integer_first = ptr;
+        ptr = from_chars_significand(ptr, last, significand, significand_digits, dropped, truncated);
+        digits.integer_last = ptr;
+
+        digits.fraction_first = digits.fraction_last = ptr;
+        if (ptr != last && *ptr == '.') {
+            digits.fraction_first = ++ptr;
+            ptr = from_chars_significand(ptr, last, significand, significand_digits, dropped, truncated);
+            digits.fraction_last = ptr;
+        }
+
+        if (digits.integer_first == digits.integer_last && digits.fraction_first == digits.fraction_last) {
+            return {first, from_chars_error::invalid_argument};
+        }
+
+        // the exponent is only consumed if it has digits, and saturates well
+        // beyond the range where the result is zero or infinite
+        //
+        bool has_exponent = false;
+        if (allow_exponent && ptr != last && (*ptr | 0x20) == 'e') {
+            char const* exponent_ptr = ptr + 1;
+            bool const exponent_negative = exponent_ptr != last && *exponent_ptr == '-';
+            if (exponent_ptr != last && (*exponent_ptr == '-' || *exponent_ptr == '+')) {
+                ++exponent_ptr;
+            }
+
+            int exponent = 0;
+            char const* const exponent_first = exponent_ptr;
+            for (; exponent_ptr != last; ++exponent_ptr) {
+                unsigned const digit = static_cast<unsigned char>(*exponent_ptr) - unsigned{'0'};
+                if (digit > 9) {
+                    break;
+                }
+                if (exponent < 100'000) {
+                    exponent = exponent * 10 + static_cast<int>(digit);
+                }
+            }
+
+            if (exponent_ptr != exponent_first) {
+                has_exponent = true;
+                digits.exponent = exponent_negative ? -exponent : exponent;
+                ptr = exponent_ptr;
+            }
+        }
+
+        if (require_exponent && !has_exponent) {
+            return {first, from_chars_error::invalid_argument};
+        }
+
+        if (significand == 0) {
+            return finish(0, ptr);
+        }
+
+        // the value is significand * 10^q, or slightly more if truncated
+        //
+        std::int64_t const wide_q = std::int64_t{digits.exponent} - (digits.fraction_last - digits.fraction_first) + dropped;
+        if (wide_q > largest_power10 || wide_q < smallest_power10) {
+            return {ptr, from_chars_error::result_out_of_range};
+        }
+        int const q = static_cast<int>(wide_q);
+
+        // Clinger's fast path: both the significand and the power of ten are
+        // exact, so a single rounding operation yields the correct result
+        //
+        if (!truncated && significand <= (std::uint64_t{1} << (mantissa_bits + 1)) && q >= -max_exact_power10 &&
+            q <= max_exact_power10) {
+            FloatT result = static_cast<FloatT>(significand);
+            if (q < 0) {
+                result /= static_cast<FloatT>(exact_powers10[-q]);
+            }
+            else {
+                result *= static_cast<FloatT>(exact_powers10[q]);
+            }
+            value = negative ? -result : result;
+            return {ptr, from_chars_error::none};
+        }
+
+        // Eisel-Lemire almost always determines the result; a truncated
+        // significand is rounded both down and up, and must agree
+        //
+        CarrierT bits = 0;
+        bool exact = false;
+        if (q >= smallest_cached_power10) {
+            exact = eisel_lemire(significand, q, bits);
+            if (exact && truncated) {
+                CarrierT upper_bits = 0;
+                exact = eisel_lemire(significand + 1, q, upper_bits) && upper_bits == bits;
+            }
+        }
+        else {
+            // the exact fallback only needs a nearby starting point
+            //
+            double approximate = static_cast<double>(significand);
+            int scale = q;
+            for (; scale < -max_exact_power10; scale += max_exact_power10) {
+                approximate /= exact_powers10[max_exact_power10];
+            }
+            approximate /= exact_powers10[-scale];
+
+            FloatT const candidate = static_cast<FloatT>(approximate);
+            std::memcpy(&bits, &candidate, sizeof bits);
+        }
+
+        if (!exact) {
+            bits = from_chars_exact<CarrierT, FloatT>(digits, bits);
+        }
+
+        if (bits == 0 || bits == infinity_bits) {
+            return {ptr, from_chars_error::result_out_of_range};
+        }
+        return finish(bits, ptr);
+    }
+
+    // matches inf, infinity, or nan in any case; returns nullptr otherwise
+    //
+    char const* detail::from_chars_nonfinite(char const* first, char const* last, bool& infinite) noexcept {
+        auto const matches = [last](char const* ptr, char const* word, int length) noexcept {
+            if (last - ptr < length) {
+                return false;
+            }
+            for (int index = 0; index != length; ++index) {
+                if ((ptr[index] | 0x20) != word[index]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        if (matches(first, "inf", 3)) {
+            infinite = true;
+            return matches(first + 3, "inity", 5) ? first + 8 : first + 3;
+        }
+        if (matches(first, "nan", 3)) {
+            infinite = false;
+            return first + 3;
+        }
+        return nullptr;
+    }
+
+    // accumulates significant digits into significand until it holds 19,
+    // and counts the digits beyond that which are dropped; leading zeroes
+    // are skipped and do not count towards the limit
+    //
+    char const* detail::from_chars_significand(
+        char const* first,
+        char const* last,
+        std::uint64_t& significand,
+        int& digits,
+        int& dropped,
+        bool& truncated) noexcept {
+        constexpr int max_digits = 19;
+
+        if (digits == 0) {
+            while (first != last && *first == '0') {
+                ++first;
+            }
+        }
+
+        while (last - first >= 8 && digits + 8 <= max_digits) {
+            std::uint64_t const chars = load_le64(first);
+            if (!is_eight_digits(chars)) {
+                break;
+            }
+            significand = significand * 100'000'000u + parse_eight_digits(chars);
+            first += 8;
+            digits += 8;
+        }
+
+        for (; first != last; ++first) {
+            unsigned const digit = static_cast<unsigned char>(*first) - unsigned{'0'};
+            if (digit > 9) {
+                break;
+            }
+            if (digits < max_digits) {
+                significand = significand * 10 + digit;
+                ++digits;
+            }
+            else {
+                ++dropped;
+                truncated |= digit != 0;
+            }
+        }
+        return first;
+    }
+
+    // Eisel-Lemire: multiplies the normalized significand by a 128-bit
+    // approximation of 5^q, which determines the correctly rounded result
+    // unless the product lands too close to a halfway point; the bits are
+    // always set to a result within one ulp, and false is returned if that
+    // result may be wrong
+    //
+    // the powers of five are dragonbox's cache entries, which are rounded up
+    // where fast_float's table is truncated; the two differ by one in the
+    // last place for the powers that are not exact in 128 bits
+    //
+    template <typename CarrierT>
+    bool detail::eisel_lemire(std::uint64_t significand, int exponent, CarrierT& bits) noexcept {
+        using FloatT = std::conditional_t<sizeof(CarrierT) == 8, double, float>;
+
+        constexpr int mantissa_bits = std::numeric_limits<FloatT>::digits - 1;
+        constexpr int exponent_bias = std::numeric_limits<FloatT>::max_exponent - 1;
+        constexpr int infinite_power = 2 * std::numeric_limits<FloatT>::max_exponent - 1;
+        constexpr std::uint64_t hidden_bit = std::uint64_t{1} << mantissa_bits;
+
+        // a product exactly halfway between two values is only possible when
+        // 5^q is exact, and the significand is a multiple of 2^-q for q < 0
+        //
+        constexpr int min_round_to_even = sizeof(CarrierT) == 8 ? -4 : -17;
+        constexpr int max_round_to_even = sizeof(CarrierT) == 8 ? 23 : 10;
+
+        bool const exact_power = exponent >= -27 && exponent <= 55;
+
+        auto const cache =
+            NANOFMT_NS::dragonbox::detail::policy_impl::cache::compact::get_cache<NANOFMT_NS::dragonbox::ieee754_binary64>(
+                exponent);
+        std::uint64_t power_high = cache.high();
+        std::uint64_t power_low = cache.low();
+        if (!exact_power) {
+            power_high -= power_low == 0;
+            --power_low;
+        }
+
+        int const leading_zeroes = countl_zero(significand);
+        std::uint64_t const normalized = significand << leading_zeroes;
+
+        // the low half of the power only matters if the bits just below the
+        // result could carry into it
+        //
+        constexpr std::uint64_t precision_mask = ~std::uint64_t{0} >> (mantissa_bits + 3);
+        auto const first_product = NANOFMT_NS::dragonbox::detail::wuint::umul128(normalized, power_high);
+        std::uint64_t product_high = first_product.high();
+        std::uint64_t product_low = first_product.low();
+        if ((product_high & precision_mask) == precision_mask) {
+            auto const second_product = NANOFMT_NS::dragonbox::detail::wuint::umul128(normalized, power_low);
+            product_low += second_product.high();
+            product_high += product_low < second_product.high();
+        }
+        bool const certain = exact_power || product_low != ~std::uint64_t{0};
+
+        int const upper_bit = static_cast<int>(product_high >> 63);
+        int const shift = upper_bit + 64 - mantissa_bits - 3;
+        std::uint64_t mantissa = product_high >> shift;
+        int power2 = (((152'170 + 65'536) * exponent) >> 16) + 63 + upper_bit - leading_zeroes + exponent_bias;
+
+        if (power2 <= 0) {
+            // subnormal, or zero; halfway points are impossible this small
+            //
+            if (-power2 + 1 >= 64) {
+                bits = 0;
+                return certain;
+            }
+            mantissa >>= -power2 + 1;
+            mantissa += mantissa & 1;
+            mantissa >>= 1;
+            power2 = mantissa < hidden_bit ? 0 : 1;
+            bits = static_cast<CarrierT>((static_cast<std::uint64_t>(power2) << mantissa_bits) | (mantissa & (hidden_bit - 1)));
+            return certain;
+        }
+
+        // a product that is exactly halfway rounds to even, rather than up
+        //
+        if (product_low <= 1 && exponent >= min_round_to_even && exponent <= max_round_to_even && (mantissa & 3) == 1 &&
+            (mantissa << shift) == product_high) {
+            mantissa &= ~std::uint64_t{1};
+        }
+
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        if (mantissa >= (hidden_bit << 1)) {
+            mantissa = hidden_bit;
+            ++power2;
+        }
+
+        if (power2 >= infinite_power) {
+            bits = static_cast<CarrierT>(static_cast<std::uint64_t>(infinite_power) << mantissa_bits);
+            return certain;
+        }
+        bits = static_cast<CarrierT>((static_cast<std::uint64_t>(power2) << mantissa_bits) | (mantissa & (hidden_bit - 1)));
+        return certain;
+    }
+
+    // correctly rounds the decimal digits by comparing them exactly against
+    // the halfway points around a candidate result, stepping the candidate
+    // until the value lies between them
+    //
+    // a halfway point has at most 767 significant digits for double, or 112
+    // for float, so digits beyond a few more than that can only break ties
+    //
+    template <typename CarrierT, typename FloatT>
+    CarrierT detail::from_chars_exact(decimal_digits const& digits, CarrierT bits) noexcept {
+        constexpr bool is_double = sizeof(FloatT) == 8;
+        constexpr int max_digits = is_double ? 800 : 120;
+        using bigint_t = bigint<is_double ? 160 : 40>;
+
+        constexpr int mantissa_bits = std::numeric_limits<FloatT>::digits - 1;
+        constexpr int exponent_bias = std::numeric_limits<FloatT>::max_exponent - 1 + mantissa_bits;
+        constexpr CarrierT hidden_bit = CarrierT{1} << mantissa_bits;
+        constexpr CarrierT infinity_bits = CarrierT{2 * std::numeric_limits<FloatT>::max_exponent - 1}
+            << mantissa_bits;
+
+        // the value is (scaled + sticky) / scale, where the division is exact
+        // and sticky is some fraction between zero and one
+        //
+        bigint_t scaled{0};
+        bigint_t scale{1};
+        int kept = 0;
+        int dropped = 0;
+        bool sticky = false;
+
+        std::uint32_t chunk = 0;
+        int chunk_digits = 0;
+        auto const accumulate = [&](char const* first, char const* last) noexcept {
+            for (; first != last; ++first) {
+                unsigned const digit = static_cast<unsigned char>(*first) - unsigned{'0'};
+                if (kept == 0 && digit == 0) {
+                    continue;
+                }
+                if (kept == max_digits) {
+                    ++dropped;
+                    sticky |= digit != 0;
+                    continue;
+                }
+                chunk = chunk * 10 + digit;
+                ++kept;
+                if (++chunk_digits == 9) {
+                    scaled.multiply(1'000'000'000u);
+                    scaled.add(chunk);
+                    chunk = 0;
+                    chunk_digits = 0;
+                }
+            }
+        };
+        accumulate(digits.integer_first, digits.integer_last);
+        accumulate(digits.fraction_first, digits.fraction_last);
+        scaled.multiply(static_cast<std::uint32_t>(pow10_table[chunk_digits]));
+        scaled.add(chunk);
+
+        auto const multiply_pow10 = [](bigint_t& target, int power) noexcept {
+            for (; power >= 9; power -= 9) {
+                target.multiply(1'000'000'000u);
+            }
+            target.multiply(static_cast<std::uint32_t>(pow10_table[power]));
+        };
+
+        int const exponent = digits.exponent - static_cast<int>(digits.fraction_last - digits.fraction_first) + dropped;
+        if (exponent >= 0) {
+            multiply_pow10(scaled, exponent);
+        }
+        else {
+            multiply_pow10(scale, -exponent);
+        }
+
+        // compares the value against halfway * 2^power
+        //
+        auto const compare_halfway = [&](std::uint64_t halfway, int power) noexcept {
+            bigint_t lhs = scaled;
+            bigint_t rhs = scale;
+            rhs.multiply_wide(halfway);
+            if (power >= 0) {
+                rhs.shift_left(power);
+            }
+            else {
+                lhs.shift_left(-power);
+            }
+            int const order = compare(lhs, rhs);
+            return order == 0 && sticky ? 1 : order;
+        };
+
+        if (bits >= infinity_bits) {
+            bits = infinity_bits - 1;
+        }
+
+        for (;;) {
+            int const biased = static_cast<int>(bits >> mantissa_bits);
+            CarrierT const fraction = bits & (hidden_bit - 1);
+            std::uint64_t const mantissa = biased == 0 ? fraction : fraction | hidden_bit;
+            int const power2 = (biased == 0 ? 1 : biased) - exponent_bias;
+            bool const odd = (mantissa & 1) != 0;
+
+            int const above = compare_halfway(2 * mantissa + 1, power2 - 1);
+            if (above > 0 || (above == 0 && odd)) {
+                if (++bits == infinity_bits) {
+                    break;
+                }
+                continue;
+            }
+
+            if (bits == 0) {
+                break;
+            }
+
+            // the gap below the smallest value of a binade is half as wide
+            //
+            int const below = fraction == 0 && biased > 1 ? compare_halfway(4 * mantissa - 1, power2 - 2)
+                                                          : compare_halfway(2 * mantissa - 1, power2 - 1);
+            if (below < 0 || (below == 0 && odd)) {
+                --bits;
+                continue;
+            }
+            break;
+        }
+        return bits;
+    }
 #endif
 } // namespace NANOFMT_NS
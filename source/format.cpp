@@ -1,26 +1,47 @@
 // Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
 
-#include "parse_utils.h"
 #include "nanofmt/charconv.h"
 #include "nanofmt/format.h"
+#include "numeric_utils.h"
+#include "parse_utils.h"
+#include "simd_utils.h"
 
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 
 namespace NANOFMT_NS {
     namespace detail {
-        static constexpr char const* parse_spec(
-            char const* in,
-            char const* end,
-            format_spec& spec,
-            char const* allowed_types) noexcept;
+        static bool format_field(
+            char const*& input,
+            char const* input_end,
+            format_args const& args,
+            int& arg_next_index,
+            bool& arg_auto_index,
+            format_output& out);
+        static format_output vformat_segments(
+            format_output out,
+            format_segment const* segments,
+            std::size_t count,
+            formatter_cache* caches,
+            format_args const& args);
+        template <typename ValueT>
+        static void format_builtin_impl(ValueT value, char const** in, char const* end, format_output& out);
+        template <typename ValueT>
+        static void format_prepared_impl(ValueT value, format_segment const& field, format_output& out);
+        template <typename ValueT>
+        static constexpr format_spec prepared_spec(format_segment const& field) noexcept;
         static void format_int_chars(
             format_output& out,
             char const* digits,
             size_t count,
             bool negative,
+            size_t prefix_length,
             format_spec const& spec) noexcept;
-        static constexpr int_format select_int_format(char type) noexcept;
+        template <typename IntT>
+        static constexpr std::size_t int_chars_length(IntT value, int_format fmt) noexcept;
+        static constexpr int_format select_int_format(char type, bool alt_form) noexcept;
+        static constexpr size_t int_prefix_length(char type, bool nonzero) noexcept;
         static constexpr char const* parse_int_spec(char const* in, char const* end, format_spec& spec) noexcept;
 #if NANOFMT_FLOAT
         static constexpr char const* parse_float_spec(char const* in, char const* end, format_spec& spec) noexcept;
@@ -36,6 +57,77 @@ namespace NANOFMT_NS {
             format_spec const& spec) noexcept;
         template <typename FloatT>
         static void format_float_impl(FloatT value, format_output& out, format_spec const& spec) noexcept;
+
+        // the sign and padding written around count digits of an integer
+        //
+        struct int_layout {
+            char sign = '\0';
+            std::size_t zero_padding = 0;
+            std::size_t fill = 0;
+        };
+
+        static constexpr int_layout layout_int(std::size_t count, bool negative, format_spec const& spec) noexcept;
+
+        // presentation types accepted by each default formatter
+        //
+        static constexpr char int_spec_types[] = "bBcdoxX";
+        static constexpr char float_spec_types[] = "aAeEfFgG";
+        static constexpr char bool_spec_types[] = "sbBcdoxX";
+        static constexpr char pointer_spec_types[] = "p";
+        static constexpr char string_spec_types[] = "s";
+
+        // how a pre-parsed spec applies to each default formatter; integers
+        // and characters are right-aligned by default
+        //
+        template <typename ValueT>
+        struct default_spec_traits {
+            static constexpr char const* types = int_spec_types;
+            static constexpr signed char align = +1;
+        };
+        template <>
+        struct default_spec_traits<float> {
+            static constexpr char const* types = float_spec_types;
+            static constexpr signed char align = -1;
+        };
+        template <>
+        struct default_spec_traits<double> {
+            static constexpr char const* types = float_spec_types;
+            static constexpr signed char align = -1;
+        };
+        template <>
+        struct default_spec_traits<bool> {
+            static constexpr char const* types = bool_spec_types;
+            static constexpr signed char align = -1;
+        };
+        template <>
+        struct default_spec_traits<void const*> {
+            static constexpr char const* types = pointer_spec_types;
+            static constexpr signed char align = -1;
+        };
+        template <>
+        struct default_spec_traits<char const*> {
+            static constexpr char const* types = string_spec_types;
+            static constexpr signed char align = -1;
+        };
+
+        // the part of a format_cursor's output that a split field is being
+        // written into, which is also the field's sink's chunk
+        //
+        struct cursor_field {
+            char* pos = nullptr;
+            char const* end = nullptr;
+            format_sink* sink = nullptr;
+        };
+
+        // past this precision every further digit of a fixed, scientific or
+        // hex float is a trailing zero, as a double has at most 1074
+        // fractional digits
+        static constexpr int float_exact_precision = 1100;
+
+        // large enough for any floating-point value at float_exact_precision
+        static constexpr std::size_t float_scratch_size = 1536;
+
+        static void cursor_field_flush(void* context, char const* data, std::size_t length) noexcept;
     } // namespace detail
 
     template <>
@@ -132,7 +224,7 @@ namespace NANOFMT_NS {
 
     template <>
     char const* detail::default_formatter<bool>::parse(char const* in, char const* end) noexcept {
-        return parse_spec(in, end, spec, "sbBcdoxX");
+        return parse_spec(in, end, spec, bool_spec_types);
     }
 
     template <>
@@ -150,22 +242,26 @@ namespace NANOFMT_NS {
 
     template <>
     char const* detail::default_formatter<void const*>::parse(char const* in, char const* end) noexcept {
-        return parse_spec(in, end, spec, "p");
+        return parse_spec(in, end, spec, pointer_spec_types);
     }
 
     template <>
     void detail::default_formatter<void const*>::format(void const* value, format_output& out) noexcept {
-        // hex encoding is 2 chars per octet
-        char chars[sizeof(value) * 2];
+        if (out.full()) {
+            out.advance += int_chars_length(reinterpret_cast<std::uintptr_t>(value), int_format::hex_prefixed);
+            return;
+        }
+
+        // hex encoding is 2 chars per octet, plus the 0x prefix
+        char chars[sizeof(value) * 2 + 2];
         char const* const end =
-            to_chars(chars, chars + sizeof chars, reinterpret_cast<std::uintptr_t>(value), int_format::hex);
-        out.append("0x");
+            to_chars(chars, chars + sizeof chars, reinterpret_cast<std::uintptr_t>(value), int_format::hex_prefixed);
         out.append(chars, end - chars);
     }
 
     template <>
     char const* detail::default_formatter<char const*>::parse(char const* in, char const* end) noexcept {
-        return parse_spec(in, end, spec, "s");
+        return parse_spec(in, end, spec, string_spec_types);
     }
 
     template <>
@@ -177,7 +273,7 @@ namespace NANOFMT_NS {
 
     template <>
     char const* detail::default_formatter<detail::char_buffer>::parse(char const* in, char const* end) noexcept {
-        return parse_spec(in, end, spec, "s");
+        return parse_spec(in, end, spec, string_spec_types);
     }
 
     template <>
@@ -187,7 +283,7 @@ namespace NANOFMT_NS {
 
     template <>
     char const* detail::default_formatter<format_string_view>::parse(char const* in, char const* end) noexcept {
-        return parse_spec(in, end, spec, "s");
+        return parse_spec(in, end, spec, string_spec_types);
     }
 
     template <>
@@ -196,6 +292,10 @@ namespace NANOFMT_NS {
     }
 
     format_output detail::vformat(format_output out, format_string format_str, format_args args) {
+        if (format_segment_data const* const prepared = format_str.prepared; prepared != nullptr) {
+            return vformat_segments(out, prepared->segments, prepared->count, prepared->caches, args);
+        }
+
         int arg_next_index = 0;
         bool arg_auto_index = true;
 
@@ -204,13 +304,13 @@ namespace NANOFMT_NS {
         char const* const input_end = format_str.end;
 
         while (input != input_end) {
-            if (*input != '{') {
-                ++input;
-                continue;
+            input = find_open_brace(input, input_end);
+            if (input == input_end) {
+                break;
             }
 
             // write out the string so far, since we don't write characters immediately
-            out.append(input_begin, input - input_begin);
+            append_text(out, input_begin, input - input_begin);
 
             ++input; // swallow the {
 
@@ -226,226 +326,719 @@ namespace NANOFMT_NS {
                 continue;
             }
 
-            // determine argument
-            int arg_index = 0;
-            if (arg_index = detail::parse_nonnegative(input, input_end); arg_index != -1) {
+            if (!format_field(input, input_end, args, arg_next_index, arg_auto_index, out)) {
+                return out;
+            }
+
+            // mark where the next text run will begin
+            input_begin = input;
+        }
+
+        // write out tail end of format string
+        append_text(out, input_begin, input - input_begin);
+        return out;
+    }
+
+    // parses and formats the replacement field that begins just after its
+    // {, leaving input after the field's closing }; returns false if the
+    // field ends formatting
+    //
+    // a field always extends to its closing }, and writes nothing if its
+    // argument doesn't exist; whatever of the spec is left unparsed is
+    // dropped, so that the field formats as it would once prepared
+    //
+    bool detail::format_field(
+        char const*& input,
+        char const* input_end,
+        format_args const& args,
+        int& arg_next_index,
+        bool& arg_auto_index,
+        format_output& out) {
+        // determine argument
+        int arg_index = 0;
+        if (arg_index = detail::parse_nonnegative(input, input_end); arg_index != -1) {
+            arg_auto_index = false;
+        }
+        else if (char const* const name_end = parse_name(input, input_end); name_end != input) {
+            // a name doesn't change how later fields are indexed
+            auto const length = static_cast<std::uint32_t>(name_end - input);
+            arg_index = args.find(input, length, hash_name(input, name_end));
+            input = name_end;
+        }
+        else if (arg_auto_index) {
+            arg_index = arg_next_index++;
+        }
+        else {
+            // we received a non-explicit index after an explicit index
+            return false;
+        }
+
+        // extract formatter specification/arguments
+        char const* spec = nullptr;
+        if (input != input_end && *input == ':') {
+            spec = ++input;
+        }
+
+        // a spec with nested fields for its width or precision has them
+        // replaced by their values before the formatter parses it
+        bool nested = false;
+        char const* const spec_end = spec != nullptr ? find_spec_end(input, input_end, nested) : input;
+        int nested_arg_index = arg_next_index;
+        if (nested && !skip_nested_fields(spec, spec_end, arg_next_index, arg_auto_index)) {
+            arg_index = -1;
+        }
+
+        input = spec_end;
+        while (input != input_end && *input != '}') {
+            ++input;
+        }
+
+        if (arg_index != -1 && nested) {
+            bool nested_auto_index = true;
+            char buffer[dynamic_spec_capacity];
+            char const* resolved = buffer;
+            char const* resolved_end = nullptr;
+            if (resolve_dynamic_spec(
+                    spec,
+                    spec_end,
+                    args,
+                    nested_arg_index,
+                    nested_auto_index,
+                    buffer,
+                    resolved_end)) {
+                args.format(static_cast<unsigned>(arg_index), &resolved, resolved_end, out);
+            }
+        }
+        else if (arg_index != -1) {
+            args.format(static_cast<unsigned>(arg_index), spec != nullptr ? &spec : nullptr, spec_end, out);
+        }
+
+        // consume the closing }
+        if (input != input_end) {
+            ++input;
+        }
+        return true;
+    }
+
+    void detail::forward_custom_output(void* context, char const* data, std::size_t length) noexcept {
+        auto& forward = *static_cast<custom_output*>(context);
+        forward.out->append(data, length);
+
+        // once the output has ended, the rest of the value is only counted
+        if (forward.out->sink == nullptr) {
+            forward.sink->chunk = nullptr;
+        }
+    }
+
+    void detail::cursor_field_flush(void* context, char const* data, std::size_t length) noexcept {
+        auto& field = *static_cast<cursor_field*>(context);
+
+        // data is in the chunk, after any characters that were discarded
+        // from its front, so it only ever moves back
+        std::memmove(field.pos, data, length);
+        field.pos += length;
+
+        // the field ends once the output is full
+        if (field.pos == field.end) {
+            field.sink->chunk = nullptr;
+            return;
+        }
+        field.sink->chunk = field.pos;
+        field.sink->capacity = static_cast<std::size_t>(field.end - field.pos);
+    }
+
+    char* detail::vformat_cursor(
+        char* dest,
+        std::size_t count,
+        format_string format_str,
+        format_args const& args,
+        format_cursor_state& state) {
+        format_output out{dest, dest + count};
+        if (state.done) {
+            return out.pos;
+        }
+
+        char const* const input_end = format_str.end;
+        char const* input = state.input != nullptr ? state.input : format_str.begin;
+        char const* scan = state.scan != nullptr ? state.scan : input;
+
+        auto const finish = [&state, &out]() noexcept {
+            state.done = true;
+            return out.pos;
+        };
+
+        if (state.at_field) {
+            // the field is formatted again straight into the output, dropping
+            // what earlier pieces hold without writing it, and stops once the
+            // output is full
+            if (out.pos == out.end) {
+                return out.pos;
+            }
+
+            int arg_next_index = state.arg_next_index;
+            bool arg_auto_index = state.arg_auto_index;
+
+            format_sink sink(out.pos, count, &cursor_field_flush);
+            cursor_field field{out.pos, out.end, &sink};
+            sink.context = &field;
+            sink.discard = state.field_offset;
+            format_output field_out = sink.output();
+            ++input; // swallow the {
+            bool const formatted = format_field(input, input_end, args, arg_next_index, arg_auto_index, field_out);
+            field_out.flush();
+
+            std::size_t const written = static_cast<std::size_t>(field.pos - out.pos);
+            out.pos = field.pos;
+            if (!formatted) {
+                return finish();
+            }
+            if (state.field_offset + written < field_out.advance) {
+                state.field_offset += written;
+                return out.pos;
+            }
+
+            state.at_field = false;
+            state.field_offset = 0;
+            state.arg_next_index = arg_next_index;
+            state.arg_auto_index = arg_auto_index;
+            scan = input;
+        }
+
+        for (;;) {
+            char const* const brace = find_open_brace(scan, input_end);
+
+            // text that doesn't fit resumes at the first unwritten character,
+            // and the search for the next { resumes from where it ended
+            std::size_t const room = static_cast<std::size_t>(out.end - out.pos);
+            std::size_t const length = static_cast<std::size_t>(brace - input);
+            if (length > room) {
+                append_text(out, input, room);
+                state.input = input + room;
+                state.scan = brace;
+                return out.pos;
+            }
+            append_text(out, input, length);
+
+            if (brace == input_end || brace + 1 == input_end) {
+                return finish();
+            }
+
+            // a {{ escape is a literal {, which begins the next text run
+            if (brace[1] == '{') {
+                input = brace + 1;
+                scan = brace + 2;
+                continue;
+            }
+
+            // a field is written directly when there is room, and resumed
+            // as a split field if it reaches the end of the output, since
+            // it may have been cut short
+            state.input = brace;
+            state.at_field = true;
+            state.field_offset = 0;
+            if (out.pos == out.end) {
+                return out.pos;
+            }
+
+            char* const field_begin = out.pos;
+            int arg_next_index = state.arg_next_index;
+            bool arg_auto_index = state.arg_auto_index;
+            input = brace + 1;
+            if (!format_field(input, input_end, args, arg_next_index, arg_auto_index, out)) {
+                return finish();
+            }
+            if (out.pos == out.end) {
+                state.field_offset = static_cast<std::size_t>(out.pos - field_begin);
+                return out.pos;
+            }
+
+            state.at_field = false;
+            state.arg_next_index = arg_next_index;
+            state.arg_auto_index = arg_auto_index;
+            scan = input;
+        }
+    }
+
+    format_output detail::vformat_segments(
+        format_output out,
+        format_segment const* segments,
+        std::size_t count,
+        formatter_cache* caches,
+        format_args const& args) {
+        for (std::size_t index = 0; index != count; ++index) {
+            format_segment const& segment = segments[index];
+            append_text(out, segment.text, segment.length);
+            if (segment.arg_index != -1) {
+                args.format(segment, caches != nullptr ? caches + index : nullptr, out);
+            }
+        }
+        return out;
+    }
+
+    // only { is special in literal text, as a lone } is written as-is; the
+    // text between replacement fields is usually much longer than the
+    // fields themselves, so it is scanned a vector or word at a time
+    //
+    char const* detail::find_open_brace(char const* first, char const* last) noexcept {
+#if NANOFMT_HAS_AVX2
+        __m256i const braces32 = _mm256_set1_epi8('{');
+        while (last - first >= 32) {
+            __m256i const chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+            auto const mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, braces32)));
+            if (mask != 0) {
+                return first + countr_zero(mask);
+            }
+            first += 32;
+        }
+#endif
+#if NANOFMT_HAS_SSE2
+        __m128i const braces16 = _mm_set1_epi8('{');
+        while (last - first >= 16) {
+            __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            auto const mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, braces16)));
+            if (mask != 0) {
+                return first + countr_zero(mask);
+            }
+            first += 16;
+        }
+#endif
+
+        // bytes equal to { become zero after the xor; the zero-byte test can
+        // only report false positives above a true zero byte, so the lowest
+        // flagged byte is always exact
+        //
+        constexpr std::uint64_t ones = 0x0101'0101'0101'0101u;
+        constexpr std::uint64_t highs = 0x8080'8080'8080'8080u;
+        while (last - first >= 8) {
+            std::uint64_t const chunk = load_le64(first) ^ (ones * '{');
+            std::uint64_t const found = (chunk - ones) & ~chunk & highs;
+            if (found != 0) {
+                return first + countr_zero(found) / 8;
+            }
+            first += 8;
+        }
+
+        while (first != last && *first != '{') {
+            ++first;
+        }
+        return first;
+    }
+
+    // format_output::append copies byte-by-byte so that it remains usable in
+    // constant expressions; literal runs are copied in bulk instead
+    //
+    void detail::append_text(format_output& out, char const* text, std::size_t length) noexcept {
+        out.advance += length;
+        for (;;) {
+            std::size_t const available = static_cast<std::size_t>(out.end - out.pos);
+            std::size_t const copied = length < available ? length : available;
+            if (copied != 0) {
+                std::memcpy(out.pos, text, copied);
+                out.pos += copied;
+            }
+            if (copied == length || out.sink == nullptr) {
+                return;
+            }
+            out.flush();
+            text += copied;
+            length -= copied;
+        }
+    }
+
+    bool detail::resolve_dynamic_spec(
+        char const* spec,
+        char const* spec_end,
+        format_args const& args,
+        int& arg_next_index,
+        bool& arg_auto_index,
+        char (&buffer)[dynamic_spec_capacity],
+        char const*& resolved_end) noexcept {
+        using types = format_arg::type;
+
+        char* output = buffer;
+        char* const output_end = buffer + dynamic_spec_capacity;
+
+        while (spec != spec_end) {
+            if (*spec != '{') {
+                if (output == output_end) {
+                    return false;
+                }
+                *output++ = *spec++;
+                continue;
+            }
+            ++spec;
+
+            int arg_index = parse_nonnegative(spec, spec_end);
+            if (arg_index != -1) {
                 arg_auto_index = false;
             }
+            else if (char const* const name_end = parse_name(spec, spec_end); name_end != spec) {
+                auto const length = static_cast<std::uint32_t>(name_end - spec);
+                arg_index = args.find(spec, length, hash_name(spec, name_end));
+                spec = name_end;
+                if (arg_index == -1) {
+                    return false;
+                }
+            }
             else if (arg_auto_index) {
                 arg_index = arg_next_index++;
             }
             else {
-                // we received a non-explicit index after an explicit index
-                return out;
+                return false;
+            }
+            if (spec == spec_end || *spec != '}') {
+                return false;
             }
+            ++spec;
+
+            // only non-negative integers that fit in an int are accepted as a
+            // width or precision, which is at most ten digits
+            unsigned long long value = 0;
+            format_arg const arg = args.get(static_cast<unsigned>(arg_index));
+            switch (arg.tag) {
+                case types::t_int:
+                    value = arg.v_int < 0 ? ~0ull : static_cast<unsigned long long>(arg.v_int);
+                    break;
+                case types::t_uint:
+                    value = arg.v_unsigned;
+                    break;
+                case types::t_long:
+                    value = arg.v_long < 0 ? ~0ull : static_cast<unsigned long long>(arg.v_long);
+                    break;
+                case types::t_ulong:
+                    value = arg.v_ulong;
+                    break;
+                case types::t_longlong:
+                    value = arg.v_longlong < 0 ? ~0ull : static_cast<unsigned long long>(arg.v_longlong);
+                    break;
+                case types::t_ulonglong:
+                    value = arg.v_ulonglong;
+                    break;
+                default:
+                    return false;
+            }
+            if (value > 0x7fff'ffffu || output_end - output < 10) {
+                return false;
+            }
+            output = to_chars(output, output_end, value);
+        }
 
-            // extract formatter specification/arguments
-            char const** spec = nullptr;
-            if (input != input_end && *input == ':') {
-                spec = &++input;
+        resolved_end = output;
+        return true;
+    }
+
+    template <typename ValueT>
+    constexpr detail::format_spec detail::prepared_spec(format_segment const& field) noexcept {
+        using traits = default_spec_traits<ValueT>;
+
+        format_spec spec = field.parsed;
+        if (!field.explicit_align) {
+            spec.align = traits::align;
+        }
+
+        char const type = spec.type;
+        spec.type = '\0';
+        for (char const* t = traits::types; type != '\0' && *t != 0; ++t) {
+            if (type == *t) {
+                spec.type = type;
+                break;
             }
+        }
+        return spec;
+    }
+
+    int format_args::find(char const* name, std::uint32_t length, std::uint32_t hash, int* slot) const noexcept {
+        using types_t = format_arg::type;
 
-            // format the value
-            args.format(arg_index, spec, input_end, out);
-            if (spec != nullptr) {
-                input = *spec;
+        // the names follow the values, and the thunks of a packed list
+        std::size_t names_index = 0;
+        std::size_t named_count = 0;
+        std::uint64_t const count = types >> detail::packed_count_shift;
+        if (count == detail::unpacked_args) {
+            names_index = static_cast<std::uint32_t>(types);
+            named_count = static_cast<std::uint16_t>(types >> detail::unpacked_named_shift);
+        }
+        else {
+            constexpr std::uint64_t type_mask = (std::uint64_t{1} << detail::packed_type_bits) - 1;
+            names_index = count;
+            for (std::uint64_t index = 0; index != count; ++index) {
+                auto const type = static_cast<types_t>((types >> (index * detail::packed_type_bits)) & type_mask);
+                if (type == types_t::t_custom) {
+                    ++names_index;
+                }
             }
+            named_count = (types >> detail::packed_named_shift) & 0xF;
+        }
 
-            // consume parse specification, and any trailing }
-            if (input != input_end && *input == '}') {
-                ++input;
+        bool const unpacked = count == detail::unpacked_args;
+        auto const match = [&](std::size_t named) noexcept -> int {
+            std::size_t const at = names_index + 2 * named;
+            unsigned long long const info = unpacked ? args[at + 1].v_ulonglong : values[at + 1].v_ulonglong;
+            char const* const candidate = unpacked ? args[at].v_cstring : values[at].v_cstring;
+            if (static_cast<std::uint32_t>(info) != hash || ((info >> 32) & 0xFFFF) != length ||
+                std::memcmp(candidate, name, length) != 0) {
+                return -1;
             }
+            return static_cast<int>(info >> 48);
+        };
 
-            // mark where the next text run will begin
-            input_begin = input;
+        if (slot != nullptr && *slot >= 0 && static_cast<std::size_t>(*slot) < named_count) {
+            if (int const index = match(static_cast<std::size_t>(*slot)); index != -1) {
+                return index;
+            }
         }
-
-        // write out tail end of format string
-        return out.append(input_begin, input - input_begin);
+        for (std::size_t named = 0; named != named_count; ++named) {
+            if (int const index = match(named); index != -1) {
+                if (slot != nullptr) {
+                    *slot = static_cast<int>(named);
+                }
+                return index;
+            }
+        }
+        return -1;
     }
 
-    void format_args::format(unsigned index, char const** in, char const* end, format_output& out) const {
-        using types = format_arg::type;
+    void format_args::format(
+        detail::format_segment const& field,
+        detail::formatter_cache* cache,
+        format_output& out) const {
+        using types_t = format_arg::type;
+
+        auto index = static_cast<unsigned>(field.arg_index);
+        if (field.arg_index == detail::named_arg_index) {
+            int const found =
+                find(field.name, field.name_length, field.name_hash, cache != nullptr ? &cache->named_slot : nullptr);
+            if (found == -1) {
+                return;
+            }
+            index = static_cast<unsigned>(found);
+        }
 
-        if (index >= count) {
+        if (field.dynamic) {
+            int arg_next_index = field.nested_arg_index;
+            bool arg_auto_index = true;
+            char buffer[detail::dynamic_spec_capacity];
+            char const* resolved = buffer;
+            char const* resolved_end = nullptr;
+            if (detail::resolve_dynamic_spec(
+                    field.spec,
+                    field.spec_end,
+                    *this,
+                    arg_next_index,
+                    arg_auto_index,
+                    buffer,
+                    resolved_end)) {
+                format(index, &resolved, resolved_end, out);
+            }
             return;
         }
 
-        format_arg const& value = values[index];
+        format_arg const value = get(index);
 
-        auto invoke = [in, end, &out](auto value) {
-            formatter<decltype(value)> fmt;
-            if (in != nullptr) {
-                *in = fmt.parse(*in, end);
-            }
-            fmt.format(value, out);
-        };
+        auto invoke = [&field, &out](auto arg_value) { detail::format_prepared_impl(arg_value, field, out); };
 
         switch (value.tag) {
-            case types::t_mono:
+            case types_t::t_mono:
                 return;
-            case types::t_char:
+            case types_t::t_char:
                 return invoke(value.v_char);
-            case types::t_int:
+            case types_t::t_int:
                 return invoke(value.v_int);
-            case types::t_uint:
+            case types_t::t_uint:
                 return invoke(value.v_unsigned);
-            case types::t_long:
+            case types_t::t_long:
                 return invoke(value.v_long);
-            case types::t_ulong:
+            case types_t::t_ulong:
                 return invoke(value.v_ulong);
-            case types::t_longlong:
+            case types_t::t_longlong:
                 return invoke(value.v_longlong);
-            case types::t_ulonglong:
+            case types_t::t_ulonglong:
                 return invoke(value.v_ulonglong);
 #if NANOFMT_FLOAT
-            case types::t_float:
+            case types_t::t_float:
                 return invoke(value.v_float);
-            case types::t_double:
+            case types_t::t_double:
                 return invoke(value.v_double);
 #endif
-            case types::t_bool:
+            case types_t::t_bool:
                 return invoke(value.v_bool);
-            case types::t_cstring:
+            case types_t::t_cstring:
                 return invoke(value.v_cstring);
-            case types::t_voidptr:
+            case types_t::t_voidptr:
                 return invoke(value.v_voidptr);
-            case types::t_custom:
-                return value.v_custom.thunk(value.v_custom.value, in, end, out);
+            case types_t::t_custom: {
+                char const* spec = field.spec;
+                return value.v_custom.thunk(
+                    value.v_custom.value,
+                    spec != nullptr ? &spec : nullptr,
+                    field.spec_end,
+                    out,
+                    cache);
+            }
             default:
                 break;
         }
     }
 
-    static constexpr char const* detail::parse_spec(
-        char const* in,
-        char const* end,
-        format_spec& spec,
-        char const* allowed_types) noexcept {
-        if (in == end) {
-            return in;
+    template <typename ValueT>
+    void detail::format_builtin_impl(ValueT value, char const** in, char const* end, format_output& out) {
+        formatter<ValueT> fmt;
+        if (in != nullptr) {
+            *in = fmt.parse(*in, end);
         }
+        fmt.format(value, out);
+    }
 
-        auto const is_align = [](char const* c, char const* e) noexcept {
-            return c != e && (*c == '<' || *c == '>' || *c == '^');
-        };
+    template <typename ValueT>
+    void detail::format_prepared_impl(ValueT value, format_segment const& field, format_output& out) {
+        formatter<ValueT> fmt;
+        if (field.spec != nullptr) {
+            fmt.spec = prepared_spec<ValueT>(field);
+        }
+        fmt.format(value, out);
+    }
 
-        // -- parse fill -
-        //
-        if (*in != '{' && *in != '}' && is_align(in + 1, end)) {
-            spec.fill = *in;
-            ++in;
+    void format_args::format(unsigned index, char const** in, char const* end, format_output& out) const {
+        using types_t = format_arg::type;
 
-            if (in == end) {
-                return in;
-            }
-        }
+        format_arg const value = get(index);
 
-        // -- parse alignment --
-        //
-        switch (*in) {
-            case '<':
-                spec.align = -1;
-                ++in;
-                break;
-            case '>':
-                spec.align = +1;
-                ++in;
-                break;
-            case '^':
-                spec.align = 0;
-                ++in;
-                break;
-            default:
-                break;
-        }
-        if (in == end) {
-            return in;
-        }
+        auto invoke = [in, end, &out](auto arg_value) { detail::format_builtin_impl(arg_value, in, end, out); };
 
-        // -- parse sign --
-        //
-        switch (*in) {
-            case '+':
-            case '-':
-            case ' ':
-                spec.sign = *in++;
-                if (in == end) {
-                    return in;
-                }
-                break;
+        switch (value.tag) {
+            case types_t::t_mono:
+                return;
+            case types_t::t_char:
+                return invoke(value.v_char);
+            case types_t::t_int:
+                return invoke(value.v_int);
+            case types_t::t_uint:
+                return invoke(value.v_unsigned);
+            case types_t::t_long:
+                return invoke(value.v_long);
+            case types_t::t_ulong:
+                return invoke(value.v_ulong);
+            case types_t::t_longlong:
+                return invoke(value.v_longlong);
+            case types_t::t_ulonglong:
+                return invoke(value.v_ulonglong);
+#if NANOFMT_FLOAT
+            case types_t::t_float:
+                return invoke(value.v_float);
+            case types_t::t_double:
+                return invoke(value.v_double);
+#endif
+            case types_t::t_bool:
+                return invoke(value.v_bool);
+            case types_t::t_cstring:
+                return invoke(value.v_cstring);
+            case types_t::t_voidptr:
+                return invoke(value.v_voidptr);
+            case types_t::t_custom:
+                return value.v_custom.thunk(value.v_custom.value, in, end, out, nullptr);
             default:
                 break;
         }
+    }
 
-        // -- parse alternate form flag --
-        //
-        if (*in == '#') {
-            spec.alt_form = true;
-            ++in;
-            if (in == end) {
-                return in;
-            }
-        }
+    void detail::format_builtin(int value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-        // -- parse zero pad flag --
-        //
-        if (*in == '0') {
-            spec.zero_pad = true;
-            ++in;
-            if (in == end) {
-                return in;
-            }
-        }
+    void detail::format_builtin(unsigned value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-        // -- parse width
-        //
-        if (int const width = detail::parse_nonnegative(in, end); width >= 0) {
-            spec.width = width;
-            if (in == end) {
-                return in;
-            }
+    void detail::format_builtin(long value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-            // a width of 0 is not allowed
-            if (width == 0) {
-                return --in;
-            }
-        }
+    void detail::format_builtin(unsigned long value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-        // -- parse precision
-        //
-        if (*in == '.') {
-            ++in;
-            int const precision = detail::parse_nonnegative(in, end);
+    void detail::format_builtin(long long value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-            if (precision < 0 || in == end) {
-                return in;
-            }
+    void detail::format_builtin(unsigned long long value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-            spec.precision = precision;
-        }
+    void detail::format_builtin(char value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-        // -- parse locale flag (ignored)
-        //
-        if (*in == 'L') {
-            ++in;
-            if (in == end) {
-                return in;
-            }
-        }
+#if NANOFMT_FLOAT
+    void detail::format_builtin(float value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
 
-        // -- parse type
-        //
-        if (allowed_types != nullptr) {
-            for (char const* t = allowed_types; *t != 0; ++t) {
-                if (*in == *t) {
-                    spec.type = *in++;
-                    break;
-                }
-            }
-        }
+    void detail::format_builtin(double value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
+#endif
 
-        return in;
+    void detail::format_builtin(bool value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
+
+    void detail::format_builtin(char const* value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
+
+    void detail::format_builtin(void const* value, char const** in, char const* end, format_output& out) {
+        format_builtin_impl(value, in, end, out);
+    }
+
+    void detail::format_builtin(int value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(unsigned value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(long value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(unsigned long value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(long long value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(unsigned long long value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(char value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+#if NANOFMT_FLOAT
+    void detail::format_builtin(float value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(double value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+#endif
+
+    void detail::format_builtin(bool value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(char const* value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
+    }
+
+    void detail::format_builtin(void const* value, format_segment const& field, format_output& out) {
+        format_prepared_impl(value, field, out);
     }
 
     void detail::format_int_chars(
@@ -453,54 +1046,133 @@ namespace NANOFMT_NS {
         char const* digits,
         size_t count,
         bool negative,
+        size_t prefix_length,
         format_spec const& spec) noexcept {
-        if (*digits == '-') {
+        if (count != 0 && *digits == '-') {
             ++digits;
             --count;
         }
 
-        char const sign_char = negative ? '-' : (spec.sign == '+') ? '+' : (spec.sign == ' ') ? ' ' : '\0';
+        // the base prefix may itself have been truncated
+        if (prefix_length > count) {
+            prefix_length = count;
+        }
+
+        int_layout const layout = layout_int(count, negative, spec);
 
-        size_t const zero_padding =
-            spec.zero_pad && ((spec.width > 0 && static_cast<std::size_t>(spec.width) > count + (sign_char != '\0')))
-            ? spec.width - count - (sign_char != '\0')
-            : 0;
+        out.fill_n(spec.fill, layout.fill);
+        if (layout.sign != '\0') {
+            out.put(layout.sign);
+        }
+        out.append(digits, prefix_length);
+        out.fill_n('0', layout.zero_padding);
+        out.append(digits + prefix_length, count - prefix_length);
+    }
+
+    constexpr detail::int_layout detail::layout_int(
+        std::size_t count,
+        bool negative,
+        format_spec const& spec) noexcept {
+        int_layout layout;
+        layout.sign = negative ? '-' : (spec.sign == '+') ? '+' : (spec.sign == ' ') ? ' ' : '\0';
 
-        size_t const total_length = (sign_char != '\0') + count + zero_padding;
+        std::size_t const sign_length = layout.sign != '\0';
+        if (spec.zero_pad && spec.width > 0 && static_cast<std::size_t>(spec.width) > count + sign_length) {
+            layout.zero_padding = spec.width - count - sign_length;
+        }
 
+        std::size_t const total_length = sign_length + count + layout.zero_padding;
         if (spec.width > 0 && spec.align > 0 && static_cast<std::size_t>(spec.width) > total_length) {
-            out.fill_n(spec.fill, static_cast<std::size_t>(spec.width) - total_length);
+            layout.fill = static_cast<std::size_t>(spec.width) - total_length;
+        }
+        return layout;
+    }
+
+    // the same length as to_chars writes, given room, but found from the
+    // bit width or decimal digit count of the value alone
+    //
+    template <typename IntT>
+    constexpr std::size_t detail::int_chars_length(IntT value, int_format fmt) noexcept {
+        std::size_t length = value < 0 ? 1 : 0;
+
+        switch (fmt) {
+            case int_format::hex_prefixed:
+            case int_format::hex_upper_prefixed:
+            case int_format::binary_prefixed:
+            case int_format::binary_upper_prefixed:
+                length += 2;
+                break;
+            case int_format::octal_prefixed:
+                length += value != 0;
+                break;
+            default:
+                break;
+        }
+
+        if (value == 0) {
+            return length + 1;
         }
 
-        if (sign_char != '\0') {
-            out.put(sign_char);
+        auto const abs_value = static_cast<std::uint64_t>(abs(value));
+        int const bits = 64 - countl_zero(abs_value);
+        switch (fmt) {
+            case int_format::hex:
+            case int_format::hex_prefixed:
+            case int_format::hex_upper:
+            case int_format::hex_upper_prefixed:
+                return length + (bits + 3) / 4;
+            case int_format::binary:
+            case int_format::binary_prefixed:
+            case int_format::binary_upper_prefixed:
+                return length + bits;
+            case int_format::octal:
+            case int_format::octal_prefixed:
+                return length + (bits + 2) / 3;
+            default:
+                return length + count_digits(abs_value);
         }
-        out.fill_n('0', zero_padding);
-        out.append(digits, count);
     }
 
-    constexpr int_format detail::select_int_format(char type) noexcept {
+    constexpr int_format detail::select_int_format(char type, bool alt_form) noexcept {
         switch (type) {
             default:
             case 'd':
                 return int_format::decimal;
             case 'x':
-                return int_format::hex;
+                return alt_form ? int_format::hex_prefixed : int_format::hex;
             case 'X':
-                return int_format::hex_upper;
+                return alt_form ? int_format::hex_upper_prefixed : int_format::hex_upper;
             case 'b':
-                return int_format::binary;
+                return alt_form ? int_format::binary_prefixed : int_format::binary;
+            case 'B':
+                return alt_form ? int_format::binary_upper_prefixed : int_format::binary;
+            case 'o':
+                return alt_form ? int_format::octal_prefixed : int_format::octal;
+        }
+    }
+
+    constexpr size_t detail::int_prefix_length(char type, bool nonzero) noexcept {
+        switch (type) {
+            case 'x':
+            case 'X':
+            case 'b':
+            case 'B':
+                return 2;
+            case 'o':
+                return nonzero ? 1 : 0;
+            default:
+                return 0;
         }
     }
 
     constexpr char const* detail::parse_int_spec(char const* in, char const* end, format_spec& spec) noexcept {
         spec.align = +1; /* right-align by default */
-        return parse_spec(in, end, spec, "bBcdoxX");
+        return parse_spec(in, end, spec, int_spec_types);
     }
 
 #if NANOFMT_FLOAT
     constexpr char const* detail::parse_float_spec(char const* in, char const* end, format_spec& spec) noexcept {
-        return parse_spec(in, end, spec, "aAeEfFgG");
+        return parse_spec(in, end, spec, float_spec_types);
     }
 #endif
 
@@ -530,8 +1202,8 @@ namespace NANOFMT_NS {
             return format_char_impl(static_cast<char>(value), out, spec);
         }
 
-        // binary encoding is the widest; FIXME: this is icky
-        char chars[sizeof(value) * 8] = {
+        // binary encoding is the widest, plus a sign and a two character prefix
+        char chars[sizeof(value) * 8 + 3] = {
             0,
         };
 
@@ -539,8 +1211,23 @@ namespace NANOFMT_NS {
             ? spec.precision
             : sizeof(chars);
 
-        const char* const end = to_chars(chars, chars + length, value, select_int_format(spec.type));
-        format_int_chars(out, chars, end - chars, value < 0, spec);
+        int_format const fmt = select_int_format(spec.type, spec.alt_form);
+
+        // when nothing can be written, the digits need only be counted
+        if (out.full()) {
+            std::size_t count = min(int_chars_length(value, fmt), length);
+            if (value < 0 && count != 0) {
+                --count;
+            }
+            int_layout const layout = layout_int(count, value < 0, spec);
+            out.advance += layout.fill + (layout.sign != '\0') + layout.zero_padding + count;
+            return;
+        }
+
+        size_t const prefix_length = spec.alt_form ? int_prefix_length(spec.type, value != 0) : 0;
+
+        const char* const end = to_chars(chars, chars + length, value, fmt);
+        format_int_chars(out, chars, end - chars, value < 0, prefix_length, spec);
     }
 
     void detail::format_string_impl(
@@ -548,6 +1235,11 @@ namespace NANOFMT_NS {
         std::size_t length,
         format_output& out,
         format_spec const& spec) noexcept {
+        if (out.full()) {
+            out.advance += spec.width > 0 ? max(length, static_cast<std::size_t>(spec.width)) : length;
+            return;
+        }
+
         if (spec.width < 0 || length >= static_cast<size_t>(spec.width)) {
             out.append(value, length);
             return;
@@ -582,31 +1274,91 @@ namespace NANOFMT_NS {
             }
         }
 
-        switch (spec.type) {
-            default:
-            case 'g':
-            case 'G':
-                out.advance_to(to_chars(
-                    out.pos,
-                    out.end,
-                    value,
-                    spec.type == 'G' ? float_format::general_upper : float_format::general,
-                    spec.precision));
-                break;
-            case 'e':
-            case 'E':
-                out.advance_to(to_chars(
-                    out.pos,
-                    out.end,
-                    value,
-                    spec.type == 'E' ? float_format::scientific_upper : float_format::scientific,
-                    spec.precision < 0 ? 6 : spec.precision));
-                break;
-            case 'f':
-            case 'F':
-                out.advance_to(
-                    to_chars(out.pos, out.end, value, float_format::fixed, spec.precision < 0 ? 6 : spec.precision));
-                break;
+        auto const write = [value, &spec](char* dest, char const* end, int precision) noexcept {
+            switch (spec.type) {
+                default:
+                case 'g':
+                case 'G':
+                    return to_chars(
+                        dest,
+                        end,
+                        value,
+                        spec.type == 'G' ? float_format::general_upper : float_format::general,
+                        precision);
+                case 'e':
+                case 'E':
+                    return to_chars(
+                        dest,
+                        end,
+                        value,
+                        spec.type == 'E' ? float_format::scientific_upper : float_format::scientific,
+                        precision < 0 ? 6 : precision);
+                case 'f':
+                case 'F':
+                    return to_chars(dest, end, value, float_format::fixed, precision < 0 ? 6 : precision);
+                case 'a':
+                case 'A':
+                    return to_chars(
+                        dest,
+                        end,
+                        value,
+                        spec.type == 'A' ? float_format::hex_upper : float_format::hex,
+                        precision);
+            }
+        };
+
+        // a value cut short by the end of the output still counts in full
+        // toward advance, which is measured in a scratch buffer; beyond
+        // float_exact_precision only trailing zeros remain, which general
+        // formatting trims and the other formats are counted as
+        int const precision = min(spec.precision, float_exact_precision);
+        std::size_t const zeros =
+            (std::isfinite(value) && spec.type != '\0' && spec.type != 'g' && spec.type != 'G')
+            ? static_cast<std::size_t>(spec.precision - precision)
+            : 0;
+
+        auto const measure = [&write, &out, precision, zeros](char* pos) noexcept {
+            char scratch[float_scratch_size];
+            out.pos = pos;
+            out.advance += static_cast<std::size_t>(write(scratch, scratch + sizeof scratch, precision) - scratch);
+            out.advance += zeros;
+        };
+
+        if (out.full()) {
+            return measure(out.pos);
+        }
+
+        // the value is written straight into the output; when that fills a
+        // sink's chunk it may have been cut short, so it is written again
+        // into the whole chunk once the chunk has been flushed
+        char* pos = write(out.pos, out.end, spec.precision);
+        if (pos == out.end && out.sink != nullptr && out.pos != out.sink->chunk) {
+            out.flush();
+            if (out.full()) {
+                return measure(out.pos);
+            }
+            pos = write(out.pos, out.end, spec.precision);
+        }
+        if (pos == out.end && out.sink != nullptr) {
+            // too long for even a whole chunk, so it is streamed from scratch,
+            // with the zeros past float_exact_precision written as padding
+            // after the digits, and before the exponent if there is one
+            char scratch[float_scratch_size];
+            char const* const scratch_end = write(scratch, scratch + sizeof scratch, precision);
+            char const* digits_end = scratch_end;
+            if (zeros != 0 && spec.type != 'f' && spec.type != 'F') {
+                char const exponent = spec.type == 'a' ? 'p' : spec.type == 'A' ? 'P' : spec.type;
+                while (*--digits_end != exponent) {
+                }
+            }
+            out.append(scratch, static_cast<std::size_t>(digits_end - scratch));
+            out.fill_n('0', zeros);
+            out.append(digits_end, static_cast<std::size_t>(scratch_end - digits_end));
+            return;
+        }
+        if (pos == out.end) {
+            return measure(pos);
         }
+        out.advance_to(pos);
     }
 } // namespace NANOFMT_NS
@@ -4,9 +4,53 @@
 
 #include "nanofmt/config.h"
 
+#include <cstdint>
 #include <type_traits>
 
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
 namespace NANOFMT_NS::detail {
+    // ASCII for each pair of decimal digits 00..99, indexed by 2*n
+    //
+    inline constexpr char decimal_digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    // powers of ten for every value representable in a 64-bit integer
+    //
+    inline constexpr std::uint64_t pow10_table[] = {
+        1ull,
+        10ull,
+        100ull,
+        1'000ull,
+        10'000ull,
+        100'000ull,
+        1'000'000ull,
+        10'000'000ull,
+        100'000'000ull,
+        1'000'000'000ull,
+        10'000'000'000ull,
+        100'000'000'000ull,
+        1'000'000'000'000ull,
+        10'000'000'000'000ull,
+        100'000'000'000'000ull,
+        1'000'000'000'000'000ull,
+        10'000'000'000'000'000ull,
+        100'000'000'000'000'000ull,
+        1'000'000'000'000'000'000ull,
+        10'000'000'000'000'000'000ull,
+    };
+
     template <typename UnsignedIntT>
     constexpr int count_digits(UnsignedIntT value) noexcept;
 
@@ -16,6 +60,11 @@ namespace NANOFMT_NS::detail {
     template <typename UnsignedIntT>
     constexpr int countl_zero(UnsignedIntT value) noexcept;
 
+    template <typename UnsignedIntT>
+    constexpr int countr_zero(UnsignedIntT value) noexcept;
+
+    constexpr std::uint64_t byteswap(std::uint64_t value) noexcept;
+
     template <typename IntT>
     constexpr auto abs(IntT value) noexcept;
 
@@ -33,50 +82,26 @@ namespace NANOFMT_NS::detail {
     constexpr int count_digits(UnsignedIntT value) noexcept {
         static_assert(std::is_unsigned_v<UnsignedIntT>);
 
-        int result = 1;
-        for (;;) {
-            if (value < 10) {
-                return result;
-            }
-            if (value < 100) {
-                return result + 1;
-            }
-            if constexpr (sizeof(UnsignedIntT) > 1) {
-                if (value < 1'000) {
-                    return result + 2;
-                }
-                if (value < 10'000) {
-                    return result + 3;
-                }
-                value /= 10'000u;
-                result += 4;
-            }
-            else {
-                return result + 2;
-            }
-        }
+        // estimate the digit count from the bit width of value, using
+        // 1233/4096 as an approximation of log10(2); the estimate is
+        // either exact or one too many, which a single comparison
+        // against the table corrects
+        //
+        // zero is treated as one, so that it is counted as a single digit
+        //
+        constexpr int bits = sizeof(UnsignedIntT) * 8;
+        auto const nonzero = static_cast<UnsignedIntT>(value | 1u);
+        int const bit_width = bits - countl_zero(nonzero);
+        int const estimate = (bit_width * 1233) >> 12;
+        return estimate + 1 - (nonzero < pow10_table[estimate]);
     }
 
-    // chop off any digits that cannot fit in the destination
+    // chop off any digits that cannot fit in the destination; shift
+    // must be less than the number of digits in value
     //
     template <typename UnsignedIntT>
     constexpr UnsignedIntT rshift10(UnsignedIntT value, int shift) noexcept {
-        if constexpr (sizeof(UnsignedIntT) > 1) {
-            while (shift >= 4) {
-                value /= 10'000u;
-                shift -= 4;
-            }
-            if (shift == 3) {
-                return value / 1'000u;
-            }
-        }
-        if (shift == 2) {
-            return value / 100u;
-        }
-        if (shift == 1) {
-            return value / 10u;
-        }
-        return value;
+        return static_cast<UnsignedIntT>(value / static_cast<UnsignedIntT>(pow10_table[shift]));
     }
 
 #if defined(__has_builtin)
@@ -98,7 +123,8 @@ namespace NANOFMT_NS::detail {
             return sizeof(value) * 8;
         }
         if constexpr (sizeof value <= 4) {
-            return __builtin_clz(value);
+            // narrow types are promoted to 32 bits, so discount the extra leading zeroes
+            return __builtin_clz(value) - static_cast<int>(32 - sizeof(value) * 8);
         }
         else {
             return __builtin_clzll(value);
@@ -107,11 +133,12 @@ namespace NANOFMT_NS::detail {
         // __builtin_clz / __builtin_clzll
         if constexpr (sizeof value <= 4) {
             unsigned long index = 0;
-            return _BitScanReverse(&index, value) ? 31 - index : 32;
+            constexpr int bits = sizeof(value) * 8;
+            return _BitScanReverse(&index, value) ? bits - 1 - static_cast<int>(index) : bits;
         }
         else {
             unsigned long index = 0;
-            return _BitScanReverse64(&index, value) ? 63 - index : 64;
+            return _BitScanReverse64(&index, value) ? 63 - static_cast<int>(index) : 64;
         }
 #else
 #    error "nanofmt::detail::countl_zero not implemented for this compiler/platform"
@@ -119,6 +146,47 @@ namespace NANOFMT_NS::detail {
 #endif
     }
 
+    template <typename UnsignedIntT>
+    constexpr int countr_zero(UnsignedIntT value) noexcept {
+        if (value == 0) {
+            return sizeof(value) * 8;
+        }
+#if NANOFMT_HAS_BUILTIN_CLZ || NANOFMT_CLANG_OR_GCC
+        if constexpr (sizeof value <= 4) {
+            return __builtin_ctz(value);
+        }
+        else {
+            return __builtin_ctzll(value);
+        }
+#elif NANOFMT_HAS_BSR
+        unsigned long index = 0;
+        if constexpr (sizeof value <= 4) {
+            _BitScanForward(&index, value);
+        }
+        else {
+            _BitScanForward64(&index, value);
+        }
+        return static_cast<int>(index);
+#else
+#    error "nanofmt::detail::countr_zero not implemented for this compiler/platform"
+        return -1;
+#endif
+    }
+
+    constexpr std::uint64_t byteswap(std::uint64_t value) noexcept {
+#if NANOFMT_CLANG_OR_GCC
+        return __builtin_bswap64(value);
+#elif NANOFMT_HAS_BSR
+        return _byteswap_uint64(value);
+#else
+        std::uint64_t result = 0;
+        for (int index = 0; index != 8; ++index) {
+            result = (result << 8) | ((value >> (index * 8)) & 0xff);
+        }
+        return result;
+#endif
+    }
+
     template <typename IntT>
     constexpr auto abs(IntT value) noexcept {
         using Unsigned = std::make_unsigned_t<IntT>;
@@ -4,28 +4,63 @@
 
 #include "nanofmt/config.h"
 
+#include <cstdint>
+
 namespace NANOFMT_NS::detail {
-    constexpr int parse_nonnegative(char const*& start, char const* end) noexcept {
-        if (start == end) {
-            return -1;
+    // value of each character as a digit in bases up to 36, or 0xff for
+    // characters that are not digits
+    //
+    struct digit_value_table {
+        constexpr digit_value_table() noexcept {
+            for (unsigned char& value : values) {
+                value = 0xff;
+            }
+            for (int digit = 0; digit != 10; ++digit) {
+                values['0' + digit] = static_cast<unsigned char>(digit);
+            }
+            for (int letter = 0; letter != 26; ++letter) {
+                values['a' + letter] = static_cast<unsigned char>(10 + letter);
+                values['A' + letter] = static_cast<unsigned char>(10 + letter);
+            }
         }
 
-        if (*start == '0') {
-            ++start;
-            return 0;
-        }
+        constexpr unsigned operator[](char ch) const noexcept { return values[static_cast<unsigned char>(ch)]; }
 
-        // there must be at least one non-zero digit
-        if (!(*start >= '1' && *start <= '9')) {
-            return -1;
-        }
+        unsigned char values[256] = {};
+    };
+
+    inline constexpr digit_value_table digit_values;
 
-        int result = 0;
-        while (start != end && *start >= '0' && *start <= '9') {
-            result *= 10;
-            result += *start - '0';
-            ++start;
+    // loads eight characters such that the first character is the least
+    // significant byte, regardless of platform endianness; compilers reduce
+    // this to a single load on little-endian targets
+    //
+    inline std::uint64_t load_le64(char const* chars) noexcept {
+        std::uint64_t result = 0;
+        for (int index = 0; index != 8; ++index) {
+            result |= static_cast<std::uint64_t>(static_cast<unsigned char>(chars[index])) << (index * 8);
         }
         return result;
     }
+
+    // true if all eight characters loaded by load_le64 are decimal digits;
+    // each byte must be 0x30..0x39, so its high nibble is 3 both before and
+    // after adding 6
+    //
+    constexpr bool is_eight_digits(std::uint64_t chars) noexcept {
+        return ((chars & 0xf0f0'f0f0'f0f0'f0f0u) |
+                (((chars + 0x0606'0606'0606'0606u) & 0xf0f0'f0f0'f0f0'f0f0u) >> 4)) == 0x3333'3333'3333'3333u;
+    }
+
+    // converts eight decimal digits loaded by load_le64 to their value, by
+    // combining adjacent digits, then pairs, then quads, with multiplies
+    //
+    constexpr std::uint32_t parse_eight_digits(std::uint64_t chars) noexcept {
+        chars -= 0x3030'3030'3030'3030u;
+        chars = (chars * 10) + (chars >> 8);
+        chars = (((chars & 0x0000'00ff'0000'00ffu) * (100 + (1'000'000ull << 32))) +
+                 (((chars >> 16) & 0x0000'00ff'0000'00ffu) * (1 + (10'000ull << 32)))) >>
+            32;
+        return static_cast<std::uint32_t>(chars);
+    }
 } // namespace NANOFMT_NS::detail
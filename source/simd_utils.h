@@ -0,0 +1,21 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#pragma once
+
+#include "nanofmt/config.h"
+
+// SSE2 is part of the x86-64 baseline, and is opt-in for 32-bit x86;
+// SSSE3 and AVX2 must be enabled explicitly by compiler flags
+//
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define NANOFMT_HAS_SSE2 1
+#    include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#    define NANOFMT_HAS_SSSE3 1
+#    include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#    define NANOFMT_HAS_AVX2 1
+#    include <immintrin.h>
+#endif
@@ -6,8 +6,12 @@
 
 #include <doctest/doctest.h>
 
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <limits>
+#include <string>
 
 TEST_CASE("nanofmt.to_chars.integers") {
     using namespace NANOFMT_NS::test;
@@ -19,6 +23,51 @@ TEST_CASE("nanofmt.to_chars.integers") {
         CHECK(to_string(10) == "10");
         CHECK(to_string(100) == "100");
         CHECK(to_string(1'000) == "1000");
+
+        CHECK(to_string(9) == "9");
+        CHECK(to_string(99) == "99");
+        CHECK(to_string(999) == "999");
+        CHECK(to_string(12'345) == "12345");
+        CHECK(to_string(1'234'567'890'123ull) == "1234567890123");
+    }
+
+    SUBCASE("digit boundaries") {
+        CHECK(to_string(static_cast<unsigned char>(9)) == "9");
+        CHECK(to_string(static_cast<unsigned char>(10)) == "10");
+        CHECK(to_string(static_cast<unsigned char>(99)) == "99");
+        CHECK(to_string(static_cast<unsigned char>(100)) == "100");
+
+        CHECK(to_string(static_cast<unsigned short>(9'999)) == "9999");
+        CHECK(to_string(static_cast<unsigned short>(10'000)) == "10000");
+
+        CHECK(to_string(999'999'999u) == "999999999");
+        CHECK(to_string(1'000'000'000u) == "1000000000");
+
+        CHECK(to_string(9'999'999'999'999'999'999ull) == "9999999999999999999");
+        CHECK(to_string(10'000'000'000'000'000'000ull) == "10000000000000000000");
+    }
+
+    SUBCASE("truncation") {
+        CHECK(to_string<1>(12'345) == "1");
+        CHECK(to_string<3>(12'345) == "123");
+        CHECK(to_string<4>(-12'345) == "-123");
+        CHECK(to_string<5>(18'446'744'073'709'551'615ull) == "18446");
+        CHECK(to_string<19>(18'446'744'073'709'551'615ull) == "1844674407370955161");
+    }
+
+    SUBCASE("untouched past result") {
+        // the bytes between the returned pointer and end are not written
+        char buffer[32];
+        std::memset(buffer, '#', sizeof buffer);
+        char const* const end = to_chars(buffer, buffer + sizeof buffer, 0xabcu, int_format::hex);
+        CHECK(std::string(buffer, static_cast<std::size_t>(end - buffer)) == "abc");
+        CHECK(std::string(end, static_cast<std::size_t>(buffer + sizeof buffer - end)).find_first_not_of('#') == std::string::npos);
+
+        std::memset(buffer, '#', sizeof buffer);
+        char const* const wide_end = to_chars(buffer, buffer + sizeof buffer, 0x12ull, int_format::hex_upper);
+        CHECK(std::string(buffer, static_cast<std::size_t>(wide_end - buffer)) == "12");
+        CHECK(buffer[2] == '#');
+        CHECK(buffer[sizeof buffer - 1] == '#');
     }
 
     SUBCASE("hex") {
@@ -27,6 +76,9 @@ TEST_CASE("nanofmt.to_chars.integers") {
 
         CHECK(to_string(0xdeadc0de, int_format::hex) == "deadc0de");
         CHECK(to_string(0xdeadc0de, int_format::hex_upper) == "DEADC0DE");
+
+        CHECK(to_string(static_cast<unsigned char>(0xab), int_format::hex) == "ab");
+        CHECK(to_string(static_cast<unsigned short>(0xbeef), int_format::hex) == "beef");
     }
 
     SUBCASE("binary") {
@@ -34,10 +86,62 @@ TEST_CASE("nanofmt.to_chars.integers") {
         CHECK(to_string(0b1, int_format::binary) == "1");
 
         CHECK(to_string(0b10011001, int_format::binary) == "10011001");
+        CHECK(to_string(static_cast<unsigned char>(0b1010), int_format::binary) == "1010");
 
         CHECK(to_string(-0b01011010, int_format::binary) == "-1011010");
     }
 
+    SUBCASE("hex widths") {
+        CHECK(to_string(0x1u, int_format::hex) == "1");
+        CHECK(to_string(0x10u, int_format::hex) == "10");
+        CHECK(to_string(0x8000'0000u, int_format::hex) == "80000000");
+        CHECK(to_string(0x0123'4567'89ab'cdefull, int_format::hex) == "123456789abcdef");
+        CHECK(to_string(0xfedc'ba98'7654'3210ull, int_format::hex_upper) == "FEDCBA9876543210");
+        CHECK(to_string(0x1'0000'0000ull, int_format::hex) == "100000000");
+
+        // compare against printf for a spread of bit patterns
+        std::uint64_t state = 0x2545'f491'4f6c'dd1dull;
+        for (int index = 0; index != 256; ++index) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            std::uint64_t const value = state >> (index % 64);
+
+            char expected[32] = {};
+            std::snprintf(expected, sizeof expected, "%llx", static_cast<unsigned long long>(value));
+            CHECK(to_string(static_cast<unsigned long long>(value), int_format::hex) == expected);
+
+            std::snprintf(expected, sizeof expected, "%X", static_cast<unsigned>(value));
+            CHECK(to_string(static_cast<unsigned>(value), int_format::hex_upper) == expected);
+        }
+    }
+
+    SUBCASE("octal") {
+        CHECK(to_string(0, int_format::octal) == "0");
+        CHECK(to_string(8, int_format::octal) == "10");
+        CHECK(to_string(0755, int_format::octal) == "755");
+        CHECK(to_string(-0755, int_format::octal) == "-755");
+        CHECK(to_string(std::numeric_limits<std::uint64_t>::max(), int_format::octal) == "1777777777777777777777");
+    }
+
+    SUBCASE("prefixed") {
+        CHECK(to_string(0, int_format::hex_prefixed) == "0x0");
+        CHECK(to_string(0xbeef, int_format::hex_prefixed) == "0xbeef");
+        CHECK(to_string(-0xbeef, int_format::hex_upper_prefixed) == "-0XBEEF");
+        CHECK(to_string(0b101, int_format::binary_prefixed) == "0b101");
+        CHECK(to_string(0b101, int_format::binary_upper_prefixed) == "0B101");
+        CHECK(to_string(0, int_format::octal_prefixed) == "0");
+        CHECK(to_string(8, int_format::octal_prefixed) == "010");
+    }
+
+    SUBCASE("radix truncation") {
+        CHECK(to_string<3>(0xabcdef, int_format::hex) == "abc");
+        CHECK(to_string<4>(0xabcdef, int_format::hex_prefixed) == "0xab");
+        CHECK(to_string<5>(0b110011001, int_format::binary) == "11001");
+        CHECK(to_string<2>(0777, int_format::octal) == "77");
+        CHECK(to_string<1>(0, int_format::hex_prefixed) == "0");
+    }
+
     SUBCASE("negatives") {
         CHECK(to_string(-0) == "0");
         CHECK(to_string(-1) == "-1");
@@ -61,6 +165,62 @@ TEST_CASE("nanofmt.to_chars.integers") {
         CHECK(to_string(std::numeric_limits<std::uint16_t>::max()) == "65535");
         CHECK(to_string(std::numeric_limits<std::uint32_t>::max()) == "4294967295");
         CHECK(to_string(std::numeric_limits<std::uint64_t>::max()) == "18446744073709551615");
+
+        CHECK(to_string(std::numeric_limits<std::uint64_t>::max(), int_format::hex) == "ffffffffffffffff");
+        CHECK(to_string(std::numeric_limits<std::int64_t>::min(), int_format::hex) == "-8000000000000000");
+        CHECK(
+            to_string(std::numeric_limits<std::uint64_t>::max(), int_format::binary) ==
+            "1111111111111111111111111111111111111111111111111111111111111111");
+    }
+}
+
+TEST_CASE("nanofmt.to_chars_many") {
+    using namespace NANOFMT_NS;
+
+    SUBCASE("decimal") {
+        int const values[] = {1, -22, 333, 0};
+        char buffer[32] = {};
+
+        to_chars_many_result const result = to_chars_many(buffer, buffer + sizeof buffer, values, 4, ", ");
+        CHECK(result.count == 4);
+        CHECK(std::string(buffer, result.ptr) == "1, -22, 333, 0");
+    }
+
+    SUBCASE("formats") {
+        unsigned const values[] = {0xff, 0x10, 0x0};
+        char buffer[32] = {};
+
+        to_chars_many_result result =
+            to_chars_many(buffer, buffer + sizeof buffer, values, 3, " ", int_format::hex_prefixed);
+        CHECK(result.count == 3);
+        CHECK(std::string(buffer, result.ptr) == "0xff 0x10 0x0");
+
+        result = to_chars_many(buffer, buffer + sizeof buffer, values, 3, "|", int_format::binary);
+        CHECK(result.count == 3);
+        CHECK(std::string(buffer, result.ptr) == "11111111|10000|0");
+    }
+
+    SUBCASE("empty") {
+        long long const values[] = {1};
+        char buffer[4] = {};
+
+        to_chars_many_result const result = to_chars_many(buffer, buffer + sizeof buffer, values, 0, ",");
+        CHECK(result.count == 0);
+        CHECK(result.ptr == buffer);
+    }
+
+    SUBCASE("overflow") {
+        unsigned long long const values[] = {123, 4567, 89};
+        char buffer[10] = {};
+
+        // "123,4567" fits; ",89" would need two more characters
+        to_chars_many_result const result = to_chars_many(buffer, buffer + sizeof buffer, values, 3, ",");
+        CHECK(result.count == 2);
+        CHECK(std::string(buffer, result.ptr) == "123,4567");
+
+        to_chars_many_result const none = to_chars_many(buffer, buffer + 2, values, 3, ",");
+        CHECK(none.count == 0);
+        CHECK(none.ptr == buffer);
     }
 }
 
@@ -116,6 +276,53 @@ TEST_CASE("nanofmt.to_chars.fixed") {
         CHECK(to_string(1.25, float_format::fixed, 1) == "1.2");
         CHECK(to_string(1.351, float_format::fixed, 1) == "1.4");
         CHECK(to_string(1.251, float_format::fixed, 1) == "1.3");
+        CHECK(to_string(0.6, float_format::fixed, 0) == "1");
+        CHECK(to_string(9.96, float_format::fixed, 1) == "10.0");
+        CHECK(to_string(99.95, float_format::fixed, 1) == "100.0");
+        CHECK(to_string(0.0006, float_format::fixed, 3) == "0.001");
+    }
+
+    SUBCASE("large precision") {
+        CHECK(to_string(0.1, float_format::fixed, 17) == "0.10000000000000001");
+        CHECK(to_string(0.1, float_format::fixed, 30) == "0.100000000000000005551115123126");
+        CHECK(to_string(0.1, float_format::fixed, 60) == "0.100000000000000005551115123125782702118158340454101562500000");
+        CHECK(to_string(1e23, float_format::fixed, 2) == "99999999999999991611392.00");
+        CHECK(to_string(0.1f, float_format::fixed, 10) == "0.1000000015");
+        CHECK(to_string(0.05, float_format::fixed, 1) == "0.1");
+        CHECK(
+            to_string(std::numeric_limits<double>::denorm_min(), float_format::fixed, 330) ==
+            "0.0000000000000000000000000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000000000000000000"
+            "00000000000000000004940656");
+    }
+
+    SUBCASE("exact values") {
+        CHECK(to_string(3.0, float_format::fixed) == "3");
+        CHECK(to_string(1024.0, float_format::fixed) == "1024");
+        CHECK(to_string(0.375, float_format::fixed) == "0.375");
+        CHECK(to_string(123.25f, float_format::fixed) == "123.25");
+        CHECK(to_string(9007199254740991.0, float_format::fixed) == "9007199254740991");
+        CHECK(to_string(9007199254740992.0, float_format::fixed) == "9007199254740992");
+
+        char expected[64] = {};
+        for (int numerator = 0; numerator < 100'000; numerator += 7) {
+            std::snprintf(expected, sizeof expected, "%d", numerator);
+            CHECK(to_string(static_cast<double>(numerator), float_format::fixed) == expected);
+            CHECK(to_string(static_cast<float>(numerator), float_format::fixed) == expected);
+
+            // sixty-fourths have at most six fractional digits
+            std::snprintf(expected, sizeof expected, "%.6f", numerator / 64.0);
+            char* last = expected + std::strlen(expected) - 1;
+            while (*last == '0') {
+                *last-- = '\0';
+            }
+            if (*last == '.') {
+                *last = '\0';
+            }
+            CHECK(to_string(numerator / 64.0, float_format::fixed) == expected);
+        }
     }
 
     SUBCASE("nonfinite") {
@@ -146,6 +353,13 @@ TEST_CASE("nanofmt.to_chars.scientifix") {
         CHECK(to_string(1e-4f, float_format::scientific) == "1e-04");
     }
 
+    SUBCASE("exact values") {
+        CHECK(to_string(0.5, float_format::scientific) == "5e-01");
+        CHECK(to_string(1024.0, float_format::scientific) == "1.024e+03");
+        CHECK(to_string(1e15, float_format::scientific) == "1e+15");
+        CHECK(to_string(-2.75f, float_format::scientific) == "-2.75e+00");
+    }
+
     SUBCASE("mixed numbers") {
         CHECK(to_string(1.55e-1f, float_format::scientific) == "1.55e-01");
         CHECK(to_string(12.55e-2f, float_format::scientific) == "1.255e-01");
@@ -163,10 +377,21 @@ TEST_CASE("nanofmt.to_chars.scientifix") {
 
     SUBCASE("rounding") {
         CHECK(to_string(1.55e-4f, float_format::scientific, 0) == "2e-04");
-        CHECK(to_string(1.35e-4f, float_format::scientific, 1) == "1.4e-04");
-        CHECK(to_string(1.25e-4f, float_format::scientific, 1) == "1.2e-04");
+        CHECK(to_string(1.35e-4f, float_format::scientific, 1) == "1.3e-04");
+        CHECK(to_string(1.25e-4f, float_format::scientific, 1) == "1.3e-04");
         CHECK(to_string(1.351e-4f, float_format::scientific, 1) == "1.4e-04");
         CHECK(to_string(1.251e-4f, float_format::scientific, 1) == "1.3e-04");
+        CHECK(to_string(9.96, float_format::scientific, 1) == "1.0e+01");
+        CHECK(to_string(95.0, float_format::scientific, 0) == "1e+02");
+    }
+
+    SUBCASE("large precision") {
+        CHECK(to_string(0.1, float_format::scientific, 25) == "1.0000000000000000555111512e-01");
+        CHECK(to_string(2.0 / 3.0, float_format::scientific, 20) == "6.66666666666666629659e-01");
+        CHECK(to_string(1e23, float_format::scientific, 20) == "9.99999999999999916114e+22");
+        CHECK(to_string(std::numeric_limits<double>::max(), float_format::scientific, 20) == "1.79769313486231570815e+308");
+        CHECK(to_string(std::numeric_limits<double>::denorm_min(), float_format::scientific, 1) == "4.9e-324");
+        CHECK(to_string(1.5, float_format::scientific, 20) == "1.50000000000000000000e+00");
     }
 
     SUBCASE("nonfinite") {
@@ -189,6 +414,15 @@ TEST_CASE("nanofmt.to_chars.general") {
         CHECK(to_string(std::numeric_limits<double>::min(), float_format::general) == "2.22507e-308");
     }
 
+    SUBCASE("rounding") {
+        CHECK(to_string(1e20, float_format::general) == "1e+20");
+        CHECK(to_string(1.96, float_format::general, 2) == "2");
+        CHECK(to_string(999.7, float_format::general, 3) == "1e+03");
+        CHECK(to_string(0.000123456789, float_format::general) == "0.000123457");
+        CHECK(to_string(0.1, float_format::general, 20) == "0.10000000000000000555");
+        CHECK(to_string(1e23, float_format::general, 17) == "9.9999999999999992e+22");
+    }
+
     SUBCASE("nonfinite") {
         CHECK(to_string(std::numeric_limits<float>::infinity(), float_format::general) == "inf");
         CHECK(to_string(-std::numeric_limits<float>::infinity(), float_format::general) == "-inf");
@@ -196,3 +430,282 @@ TEST_CASE("nanofmt.to_chars.general") {
         CHECK(to_string(-std::numeric_limits<float>::quiet_NaN(), float_format::general) == "-nan");
     }
 }
+
+TEST_CASE("nanofmt.to_chars.hex") {
+    using namespace NANOFMT_NS::test;
+    using namespace NANOFMT_NS;
+
+    SUBCASE("shortest") {
+        CHECK(to_string(0.0, float_format::hex) == "0p+0");
+        CHECK(to_string(1.0, float_format::hex) == "1p+0");
+        CHECK(to_string(-1.5, float_format::hex) == "-1.8p+0");
+        CHECK(to_string(0.1, float_format::hex) == "1.999999999999ap-4");
+        CHECK(to_string(0.1f, float_format::hex) == "1.99999ap-4");
+        CHECK(to_string(1024.0f, float_format::hex_upper) == "1P+10");
+        CHECK(to_string(255.0 / 256.0, float_format::hex_upper) == "1.FEP-1");
+    }
+
+    SUBCASE("bounds") {
+        CHECK(to_string(std::numeric_limits<float>::max(), float_format::hex) == "1.fffffep+127");
+        CHECK(to_string(std::numeric_limits<double>::max(), float_format::hex) == "1.fffffffffffffp+1023");
+
+        CHECK(to_string(std::numeric_limits<float>::min(), float_format::hex) == "1p-126");
+        CHECK(to_string(std::numeric_limits<double>::min(), float_format::hex) == "1p-1022");
+
+        CHECK(to_string(std::numeric_limits<float>::denorm_min(), float_format::hex) == "0.000002p-126");
+        CHECK(to_string(std::numeric_limits<double>::denorm_min(), float_format::hex) == "0.0000000000001p-1022");
+    }
+
+    SUBCASE("precision") {
+        CHECK(to_string(1.0, float_format::hex, 0) == "1p+0");
+        CHECK(to_string(1.0, float_format::hex, 3) == "1.000p+0");
+        CHECK(to_string(0.1, float_format::hex, 20) == "1.999999999999a0000000p-4");
+        CHECK(to_string(0.1f, float_format::hex_upper, 8) == "1.99999A00P-4");
+    }
+
+    SUBCASE("rounding") {
+        CHECK(to_string(0.1, float_format::hex, 3) == "1.99ap-4");
+        CHECK(to_string(1.03125, float_format::hex, 1) == "1.0p+0");
+        CHECK(to_string(1.09375, float_format::hex, 1) == "1.2p+0");
+        CHECK(to_string(1.5, float_format::hex, 0) == "2p+0");
+        CHECK(to_string(2.5, float_format::hex, 0) == "1p+1");
+        CHECK(to_string(1.9375, float_format::hex, 0) == "2p+0");
+        CHECK(to_string(1.96875, float_format::hex, 1) == "2.0p+0");
+    }
+
+    SUBCASE("nonfinite") {
+        CHECK(to_string(std::numeric_limits<float>::infinity(), float_format::hex) == "inf");
+        CHECK(to_string(-std::numeric_limits<double>::infinity(), float_format::hex_upper) == "-INF");
+        CHECK(to_string(std::numeric_limits<float>::quiet_NaN(), float_format::hex_upper) == "NAN");
+    }
+
+    SUBCASE("truncation") {
+        CHECK(to_string<4>(0.1, float_format::hex) == "1.99");
+        CHECK(to_string<20>(0.1, float_format::hex) == "1.999999999999ap-4");
+    }
+
+    SUBCASE("untouched past result") {
+        char buffer[32];
+        std::memset(buffer, '#', sizeof buffer);
+        char const* const end = to_chars(buffer, buffer + sizeof buffer, 1.5, float_format::hex);
+        CHECK(std::string(buffer, static_cast<std::size_t>(end - buffer)) == "1.8p+0");
+        CHECK(std::string(end, static_cast<std::size_t>(buffer + sizeof buffer - end)).find_first_not_of('#') == std::string::npos);
+    }
+}
+
+TEST_CASE("nanofmt.from_chars.integers") {
+    using namespace NANOFMT_NS::test;
+    using namespace NANOFMT_NS;
+
+    SUBCASE("decimal") {
+        CHECK(parse<int>("0").value == 0);
+        CHECK(parse<int>("7").value == 7);
+        CHECK(parse<int>("-7").value == -7);
+        CHECK(parse<int>("0042").value == 42);
+        CHECK(parse<unsigned>("123456789").value == 123456789u);
+        CHECK(parse<std::uint64_t>("1234567812345678").value == 1234567812345678u);
+
+        auto const trailing = parse<int>("123abc");
+        CHECK(trailing.value == 123);
+        CHECK(trailing.length == 3);
+        CHECK(trailing.ec == from_chars_error::none);
+    }
+
+    SUBCASE("bounds") {
+        CHECK(parse<signed char>("-128").value == -128);
+        CHECK(parse<signed char>("127").value == 127);
+        CHECK(parse<unsigned char>("255").value == 255);
+        CHECK(parse<std::int64_t>("-9223372036854775808").value == std::numeric_limits<std::int64_t>::min());
+        CHECK(parse<std::int64_t>("9223372036854775807").value == std::numeric_limits<std::int64_t>::max());
+        CHECK(parse<std::uint64_t>("18446744073709551615").value == std::numeric_limits<std::uint64_t>::max());
+        CHECK(
+            parse<std::uint64_t>("000000000000000000000018446744073709551615").value ==
+            std::numeric_limits<std::uint64_t>::max());
+    }
+
+    SUBCASE("out of range") {
+        auto const narrow = parse<signed char>("128");
+        CHECK(narrow.ec == from_chars_error::result_out_of_range);
+        CHECK(narrow.length == 3);
+        CHECK(parse<signed char>("-129").ec == from_chars_error::result_out_of_range);
+        CHECK(parse<std::uint64_t>("18446744073709551616").ec == from_chars_error::result_out_of_range);
+
+        auto const wide = parse<std::uint64_t>("123456789012345678901234567890", int_format::decimal);
+        CHECK(wide.ec == from_chars_error::result_out_of_range);
+        CHECK(wide.length == 30);
+        CHECK(parse<std::uint64_t>("1ffffffffffffffff", int_format::hex).ec == from_chars_error::result_out_of_range);
+    }
+
+    SUBCASE("invalid") {
+        auto const empty = parse<int>("");
+        CHECK(empty.ec == from_chars_error::invalid_argument);
+        CHECK(empty.length == 0);
+        CHECK(parse<int>("-").ec == from_chars_error::invalid_argument);
+        CHECK(parse<int>("+1").ec == from_chars_error::invalid_argument);
+        CHECK(parse<int>(" 1").ec == from_chars_error::invalid_argument);
+        CHECK(parse<unsigned>("-1").ec == from_chars_error::invalid_argument);
+        CHECK(parse<int>("ff", int_format::hex_prefixed).ec == from_chars_error::invalid_argument);
+    }
+
+    SUBCASE("radix") {
+        CHECK(parse<int>("ff", int_format::hex).value == 255);
+        CHECK(parse<int>("FF", int_format::hex).value == 255);
+        CHECK(parse<int>("-0x1f", int_format::hex_prefixed).value == -31);
+        CHECK(parse<int>("0X1F", int_format::hex_upper_prefixed).value == 31);
+        CHECK(parse<int>("1011", int_format::binary).value == 11);
+        CHECK(parse<int>("0b1011", int_format::binary_prefixed).value == 11);
+        CHECK(parse<int>("0B1011", int_format::binary_upper_prefixed).value == 11);
+        CHECK(parse<int>("755", int_format::octal).value == 0755);
+        CHECK(parse<int>("0755", int_format::octal_prefixed).value == 0755);
+        CHECK(parse<int>("0", int_format::octal_prefixed).value == 0);
+        CHECK(parse<std::uint64_t>("ffffffffffffffff", int_format::hex).value == ~std::uint64_t{0});
+        CHECK(parse<std::uint64_t>("1777777777777777777777", int_format::octal).value == ~std::uint64_t{0});
+    }
+
+    SUBCASE("round trip") {
+        int_format const formats[] = {
+            int_format::decimal,
+            int_format::hex,
+            int_format::hex_upper_prefixed,
+            int_format::binary_prefixed,
+            int_format::octal_prefixed,
+        };
+        std::int64_t const values[] = {
+            0,
+            1,
+            -1,
+            99999999,
+            100000000,
+            -1234567890123,
+            std::numeric_limits<std::int64_t>::min(),
+            std::numeric_limits<std::int64_t>::max(),
+        };
+        for (int_format const fmt : formats) {
+            for (std::int64_t const value : values) {
+                auto const str = to_string(value, fmt);
+                std::int64_t parsed = 0;
+                from_chars_result const result = from_chars(str.buffer, str.buffer + str.size, parsed, fmt);
+                CHECK(result.ec == from_chars_error::none);
+                CHECK(result.ptr == str.buffer + str.size);
+                CHECK(parsed == value);
+            }
+        }
+    }
+}
+
+TEST_CASE("nanofmt.from_chars.floating") {
+    using namespace NANOFMT_NS::test;
+    using namespace NANOFMT_NS;
+
+    SUBCASE("decimal") {
+        CHECK(parse<double>("0").value == 0.0);
+        CHECK(parse<double>("1").value == 1.0);
+        CHECK(parse<double>("-1.5").value == -1.5);
+        CHECK(parse<double>("0.1").value == 0.1);
+        CHECK(parse<double>(".25").value == 0.25);
+        CHECK(parse<double>("2.").value == 2.0);
+        CHECK(parse<double>("1e10").value == 1e10);
+        CHECK(parse<double>("1.25E-3").value == 1.25e-3);
+        CHECK(parse<double>("00000.00001").value == 1e-5);
+        CHECK(parse<float>("3.14159").value == 3.14159f);
+        CHECK(parse<float>("1e-45").value == 1e-45f);
+
+        auto const negative_zero = parse<double>("-0.0");
+        CHECK(negative_zero.value == 0.0);
+        CHECK(std::signbit(negative_zero.value));
+
+        auto const trailing = parse<double>("1.5e+x");
+        CHECK(trailing.value == 1.5);
+        CHECK(trailing.length == 3);
+    }
+
+    SUBCASE("rounding") {
+        // exactly halfway between 1 and the next double, and just above it
+        CHECK(parse<double>("1.00000000000000011102230246251565404236316680908203125").value == 1.0);
+        CHECK(
+            parse<double>("1.00000000000000011102230246251565404236316680908203125000000000000000001").value ==
+            1.0000000000000002);
+        CHECK(parse<double>("9007199254740993").value == 9007199254740992.0);
+        CHECK(parse<double>("9007199254740995").value == 9007199254740996.0);
+        CHECK(parse<double>("2.2250738585072011e-308").value == 2.225073858507201e-308);
+        CHECK(parse<double>("4.9406564584124654e-324").value == std::numeric_limits<double>::denorm_min());
+        CHECK(parse<double>("2.4703282292062328e-324").value == std::numeric_limits<double>::denorm_min());
+        CHECK(parse<double>("1.7976931348623157e308").value == std::numeric_limits<double>::max());
+        CHECK(parse<float>("16777217").value == 16777216.0f);
+        CHECK(parse<float>("3.4028235e38").value == std::numeric_limits<float>::max());
+    }
+
+    SUBCASE("formats") {
+        CHECK(parse<double>("1e5", float_format::fixed).length == 1);
+        CHECK(parse<double>("1e5", float_format::scientific).value == 1e5);
+        CHECK(parse<double>("1E5", float_format::scientific_upper).value == 1e5);
+        CHECK(parse<double>("1e5", float_format::general_upper).value == 1e5);
+        CHECK(parse<double>("15", float_format::scientific).ec == from_chars_error::invalid_argument);
+        CHECK(parse<double>("1.5", float_format::hex).ec == from_chars_error::invalid_argument);
+    }
+
+    SUBCASE("nonfinite") {
+        CHECK(parse<double>("inf").value == std::numeric_limits<double>::infinity());
+        CHECK(parse<double>("-Infinity").value == -std::numeric_limits<double>::infinity());
+        CHECK(parse<double>("infinite").length == 3);
+        CHECK(std::isnan(parse<double>("nan").value));
+        CHECK(std::isnan(parse<float>("-NaN").value));
+    }
+
+    SUBCASE("out of range") {
+        auto const huge = parse<double>("1e309");
+        CHECK(huge.ec == from_chars_error::result_out_of_range);
+        CHECK(huge.length == 5);
+        CHECK(parse<double>("2e-324").ec == from_chars_error::result_out_of_range);
+        CHECK(parse<float>("3.5e38").ec == from_chars_error::result_out_of_range);
+        CHECK(parse<double>("1e-99999999999").ec == from_chars_error::result_out_of_range);
+        CHECK(parse<double>("0e99999999999").ec == from_chars_error::none);
+    }
+
+    SUBCASE("invalid") {
+        CHECK(parse<double>("").ec == from_chars_error::invalid_argument);
+        CHECK(parse<double>(".").ec == from_chars_error::invalid_argument);
+        CHECK(parse<double>("-").ec == from_chars_error::invalid_argument);
+        CHECK(parse<double>("+1").ec == from_chars_error::invalid_argument);
+        CHECK(parse<double>("e5").ec == from_chars_error::invalid_argument);
+        CHECK(parse<double>("in").ec == from_chars_error::invalid_argument);
+    }
+
+    SUBCASE("round trip") {
+        // shortest representations of bit patterns from a simple generator,
+        // which covers subnormals, tiny and huge exponents, and many digits;
+        // general is also checked at full precision
+        //
+        std::uint64_t state = 0x9e37'79b9'7f4a'7c15u;
+        for (int index = 0; index != 20'000; ++index) {
+            state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+
+            double value = 0;
+            std::memcpy(&value, &state, sizeof value);
+            if (std::isfinite(value)) {
+                for (auto const& str :
+                     {to_string(value, float_format::scientific), to_string(value, float_format::general, 17)}) {
+                    double parsed = 0;
+                    from_chars_result const result = from_chars(str.buffer, str.buffer + str.size, parsed);
+                    CHECK(result.ec == from_chars_error::none);
+                    CHECK(result.ptr == str.buffer + str.size);
+                    CHECK(std::memcmp(&parsed, &value, sizeof value) == 0);
+                }
+            }
+
+            float narrow = 0;
+            auto const narrow_bits = static_cast<std::uint32_t>(state >> 32);
+            std::memcpy(&narrow, &narrow_bits, sizeof narrow);
+            if (std::isfinite(narrow)) {
+                for (auto const& str :
+                     {to_string(narrow, float_format::scientific), to_string(narrow, float_format::general, 9)}) {
+                    float parsed = 0;
+                    from_chars_result const result = from_chars(str.buffer, str.buffer + str.size, parsed);
+                    CHECK(result.ec == from_chars_error::none);
+                    CHECK(result.ptr == str.buffer + str.size);
+                    CHECK(std::memcmp(&parsed, &narrow, sizeof narrow) == 0);
+                }
+            }
+        }
+    }
+}
@@ -8,6 +8,7 @@
 
 #include <doctest/doctest.h>
 
+#include <chrono>
 #include <cstdint>
 #include <limits>
 
@@ -18,6 +19,15 @@ struct custom_type {
     int value = 0;
 };
 
+struct tagged_type {
+    char const* name = nullptr;
+};
+
+// formatted by writing through pos directly, rather than with append
+struct direct_type {
+    char const* text = nullptr;
+};
+
 struct unknown {};
 
 namespace NANOFMT_NS {
@@ -45,6 +55,44 @@ namespace NANOFMT_NS {
             out.format("custom{{{}}", custom.value);
         }
     };
+
+    template <>
+    struct formatter<tagged_type> {
+        static inline int parse_count = 0;
+        bool upper = false;
+
+        char const* parse(char const* in, char const* end) noexcept {
+            ++parse_count;
+            if (in != end && *in == 'U') {
+                upper = true;
+                ++in;
+            }
+            return in;
+        }
+
+        void format(tagged_type tagged, format_output& out) {
+            out.append(upper ? "TAG:" : "tag:");
+            out.append(tagged.name);
+        }
+
+        static inline int measure_count = 0;
+
+        std::size_t measure(tagged_type tagged) const noexcept {
+            ++measure_count;
+            return 4 + std::strlen(tagged.name);
+        }
+    };
+
+    template <>
+    struct formatter<direct_type> {
+        constexpr char const* parse(char const* in, char const*) noexcept {
+            return in;
+        }
+
+        void format(direct_type direct, format_output& out) {
+            out.advance_to(copy_to(out.pos, out.end, direct.text));
+        }
+    };
 } // namespace NANOFMT_NS
 
 static_assert(NANOFMT_NS::detail::has_formatter<custom_type>::value, "has_formatter failed");
@@ -70,6 +118,26 @@ TEST_CASE("nanofmt.format.core") {
         CHECK((end - buffer) == 12);
         CHECK(std::strncmp(buffer, "Hello, World", sizeof buffer) == 0);
     }
+
+    SUBCASE("long literal text") {
+        using namespace NANOFMT_NS::test;
+
+        // literal text is scanned in blocks, so place fields around the block
+        // boundaries as well as in the scalar tail
+        //
+        for (std::size_t const offset : {0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100}) {
+            std::string const text(offset, 'x');
+            std::string const format_str = text + "{}" + text + "}{{" + text + "{}";
+            std::string const expected = text + "7" + text + "}{" + text + "8";
+
+            CHECK(sformat(format_string{format_str}, 7, 8) == expected.c_str());
+            CHECK(format_length(format_string{format_str}, 7, 8) == expected.size());
+
+            char buffer[48];
+            format_to(buffer, format_string{format_str}, 7, 8);
+            CHECK(expected.compare(0, sizeof buffer - 1, buffer) == 0);
+        }
+    }
 }
 
 TEST_CASE("nanofmt.format.append") {
@@ -113,6 +181,25 @@ TEST_CASE("nanofmt.format.integers") {
         CHECK(sformat("{:08X}", 0xDEAD) == "0000DEAD");
     }
 
+    SUBCASE("octal") {
+        CHECK(sformat("{:o}", 0) == "0");
+        CHECK(sformat("{:o}", 8) == "10");
+        CHECK(sformat("{:o}", -0755) == "-755");
+    }
+
+    SUBCASE("alternate form") {
+        CHECK(sformat("{:#x}", 255) == "0xff");
+        CHECK(sformat("{:#X}", 255) == "0XFF");
+        CHECK(sformat("{:#b}", 5) == "0b101");
+        CHECK(sformat("{:#B}", 5) == "0B101");
+        CHECK(sformat("{:#o}", 8) == "010");
+        CHECK(sformat("{:#o}", 0) == "0");
+        CHECK(sformat("{:#x}", -255) == "-0xff");
+        CHECK(sformat("{:#08x}", 255) == "0x0000ff");
+        CHECK(sformat("{:#08x}", -255) == "-0x000ff");
+        CHECK(sformat("{:#8x}", 255) == "    0xff");
+    }
+
     SUBCASE("binary") {
         CHECK(sformat("{:b}", 0) == "0");
         CHECK(sformat("{:b}", 0b11011) == "11011");
@@ -153,6 +240,16 @@ TEST_CASE("nanofmt.format.floating") {
 
         CHECK(sformat("{:G}", -.000'123) == "-0.000123");
         CHECK(sformat("{:G}", std::numeric_limits<float>::quiet_NaN()) == "NAN");
+
+        CHECK(sformat("{:A}", 0.1) == "1.999999999999AP-4");
+        CHECK(sformat("{:A}", std::numeric_limits<double>::infinity()) == "INF");
+    }
+
+    SUBCASE("hex") {
+        CHECK(sformat("{:a}", 1.0) == "1p+0");
+        CHECK(sformat("{:a}", -0.75f) == "-1.8p-1");
+        CHECK(sformat("{:.2a}", 0.1) == "1.9ap-4");
+        CHECK(sformat("{:+a}", 3.0) == "+1.8p+1");
     }
 }
 
@@ -240,6 +337,596 @@ TEST_CASE("nanofmt.format.custom") {
     CHECK(sformat("{}", fwd_only_type{}) == "fwd_only_type");
 }
 
+TEST_CASE("nanofmt.format.compiled") {
+    using namespace NANOFMT_NS;
+    using namespace NANOFMT_NS::test;
+
+    SUBCASE("segments") {
+        format_string const compiled = NANOFMT_COMPILE("a{}b{{c}}{1:>4}");
+        REQUIRE(compiled.prepared != nullptr);
+        CHECK(compiled.prepared->count == 3);
+
+        // segment data is carried behind a single pointer
+        static_assert(sizeof(format_string) == 3 * sizeof(void*));
+    }
+
+    SUBCASE("matches runtime") {
+        CHECK(sformat(NANOFMT_COMPILE("")) == "");
+        CHECK(sformat(NANOFMT_COMPILE("plain text")) == "plain text");
+        CHECK(sformat(NANOFMT_COMPILE("{{}}{{")) == "{}}{");
+        CHECK(sformat(NANOFMT_COMPILE("{} {} {}"), 1, "two", 3.5) == "1 two 3.5");
+        CHECK(sformat(NANOFMT_COMPILE("{1}{0}{1}"), 'a', 'b') == "bab");
+        CHECK(sformat(NANOFMT_COMPILE("{:6d}|{:*>7}|{:06}"), 1234, 42, -12) == "  1234|*****42|-00012");
+        CHECK(sformat(NANOFMT_COMPILE("{:#08x} {:+.2f} {:E}"), 255, 1.5, 0.25) == "0x0000ff +1.50 2.500000E-01");
+        CHECK(sformat(NANOFMT_COMPILE("{:>5}|{:d}|{:x}"), "ab", true, 'A') == "   ab|1|41");
+        CHECK(sformat(NANOFMT_COMPILE("{:p}"), nullptr) == "0x0");
+        CHECK(sformat(NANOFMT_COMPILE("{}"), custom_enum::foo) == "foo");
+        CHECK(sformat(NANOFMT_COMPILE("{}"), custom_type{3}) == "custom{3}");
+        CHECK(sformat(NANOFMT_COMPILE("{} {}"), 1) == "1 ");
+    }
+
+    SUBCASE("invalid types") {
+        // a type the argument does not support is ignored
+        CHECK(sformat(NANOFMT_COMPILE("{:f}"), 12) == "12");
+        CHECK(sformat(NANOFMT_COMPILE("{:x}"), "str") == "str");
+    }
+
+    SUBCASE("truncation") {
+        char buffer[8];
+        char const* const end = format_to(buffer, NANOFMT_COMPILE("{}-{}-{}"), 1234, 5678, 9);
+        CHECK(std::strcmp(buffer, "1234-56") == 0);
+        CHECK(end == buffer + 7);
+
+        CHECK(format_length(NANOFMT_COMPILE("{0} = 0x{0:X} = 0b{0:b}"), 28) == 19);
+    }
+}
+
+TEST_CASE("nanofmt.format.prepared") {
+    using namespace NANOFMT_NS;
+    using namespace NANOFMT_NS::test;
+
+    SUBCASE("segments") {
+        prepared_format<> const prepared(format_string{"a{}b{{c}}{1:>4}"});
+        CHECK(prepared.prepared());
+        CHECK(prepared.segment_count == 3);
+
+        format_string const converted = prepared;
+        REQUIRE(converted.prepared != nullptr);
+        CHECK(converted.prepared->segments == prepared.segments);
+
+        // a copy formats from its own segments
+        prepared_format<> copy = prepared;
+        format_string const copied = copy;
+        REQUIRE(copied.prepared != nullptr);
+        CHECK(copied.prepared->segments == copy.segments);
+        CHECK(sformat(copy, 1, 22) == "a1b{c}}  22");
+        copy = prepared_format<>(format_string{"{}"});
+        CHECK(sformat(copy, 5) == "5");
+    }
+
+    SUBCASE("formatting") {
+        std::string const runtime = "{:>6}|{0:#x}|{1}|{2:.3f}";
+        prepared_format<> const prepared(format_string{runtime});
+        CHECK(sformat(prepared, 255, "two", 0.5) == "   255|0xff|two|0.500");
+        CHECK(sformat(prepared, 16, "x", 2.0) == "    16|0x10|x|2.000");
+        CHECK(format_length(prepared_format<>(format_string{"{:>6}|{0:#x}|{1}"}), 255, "two") == 15);
+
+        char buffer[10];
+        format_to(buffer, prepared, 255, "two", 0.5);
+        CHECK(std::strcmp(buffer, "   255|0x") == 0);
+    }
+
+    SUBCASE("capacity") {
+        // too many segments falls back to scanning the string at format time
+        prepared_format<2> const prepared(format_string{"{}-{}-{}"});
+        CHECK(!prepared.prepared());
+        CHECK(sformat(prepared, 1, 2, 3) == "1-2-3");
+    }
+
+    SUBCASE("custom formatters") {
+        using tagged_formatter = formatter<tagged_type>;
+
+        std::string const runtime = "{:U}/{}";
+        prepared_format<> const prepared(format_string{runtime});
+
+        // each field's formatter is parsed once, on first use
+        tagged_formatter::parse_count = 0;
+        CHECK(sformat(prepared, tagged_type{"a"}, tagged_type{"b"}) == "TAG:a/tag:b");
+        CHECK(sformat(prepared, tagged_type{"c"}, tagged_type{"d"}) == "TAG:c/tag:d");
+        CHECK(tagged_formatter::parse_count == 1);
+
+        // a different type in the same field is parsed again
+        CHECK(sformat(prepared, custom_type{1}, tagged_type{"e"}) == "custom{1}/tag:e");
+        CHECK(sformat(prepared, tagged_type{"f"}, tagged_type{"g"}) == "TAG:f/tag:g");
+        CHECK(tagged_formatter::parse_count == 2);
+
+        // runtime strings parse on every call
+        CHECK(sformat(format_string{runtime}, tagged_type{"h"}, tagged_type{"i"}) == "TAG:h/tag:i");
+        CHECK(tagged_formatter::parse_count == 3);
+    }
+
+    SUBCASE("malformed fields") {
+        // a field extends to its closing }, dropping what its spec leaves
+        // unparsed, and a missing argument writes nothing, on every path
+        auto const check = [](char const* format, char const* expected, auto const&... args) {
+            std::string const runtime = format;
+            prepared_format<> const prepared(format_string{runtime});
+            CHECK(sformat(format_string{runtime}, args...) == expected);
+            CHECK(sformat(prepared, args...) == expected);
+
+            char buffer[32];
+            format_inline_to(buffer, format_string{runtime}, args...);
+            CHECK(std::strcmp(buffer, expected) == 0);
+            format_inline_to(buffer, prepared, args...);
+            CHECK(std::strcmp(buffer, expected) == 0);
+        };
+
+        check("[{3:>5}]|{0}", "[]|1", 1);
+        check("[{:.1e}]", "[5]", 5);
+        check("[{:=5}]", "[5]", 5);
+        check("[{0x}]", "[5]", 5);
+        check("[{:>4d!}]", "[  12]", 12);
+        check("[{:.2}]", "[3.1]", 3.14159);
+        check("[{:.{}}]", "[3.1]", 3.14159, 2);
+        check("[{missing:>{}}]|{}", "[]|2", 1, 2);
+
+        CHECK(sformat(NANOFMT_COMPILE("[{3:>5}]|{0}"), 1) == "[]|1");
+        CHECK(sformat(NANOFMT_COMPILE("[{:=5}]"), 5) == "[5]");
+    }
+}
+
+TEST_CASE("nanofmt.format.inline") {
+    using namespace NANOFMT_NS;
+
+    auto const check = [](format_string format_str, auto const&... args) {
+        char expected[128];
+        char actual[128];
+        char* const expected_end = format_to(expected, format_str, args...);
+        char* const actual_end = format_inline_to(actual, format_str, args...);
+        CHECK(std::strcmp(actual, expected) == 0);
+        CHECK((actual_end - actual) == (expected_end - expected));
+    };
+
+    SUBCASE("builtins") {
+        char chars[] = "chars";
+        short const small = -7;
+        unsigned char const byte = 200;
+        void const* pointer = &small;
+
+        check("{} {} {} {} {}", 42, -1ll, 7ul, 'x', true);
+        check("{:>6}|{:#x}|{:08.3f}|{:e}", 123, 255u, 3.25, 1.5f);
+        check("{} {} {} {:s}", "literal", chars, small, byte);
+        check("{} {}", pointer, nullptr);
+        check("{1} {0} {1:>4}", 1, 2);
+        check("{{}} {} }} {{{}}}", 1, 2);
+    }
+
+    SUBCASE("enums and custom types") {
+        check("{} {} {}", standard_enum::two, custom_enum::bar, custom_type{9});
+        check("{:U}/{}", tagged_type{"a"}, tagged_type{"b"});
+    }
+
+    SUBCASE("truncation") {
+        char buffer[8];
+        char* const end = format_inline_to(buffer, "{}-{}-{}", 1234, 5678, 9);
+        CHECK(std::strcmp(buffer, "1234-56") == 0);
+        CHECK((end - buffer) == 7);
+
+        char unterminated[4];
+        CHECK((format_inline_to_n(unterminated, sizeof unterminated, "{}", 123456) - unterminated) == 4);
+    }
+
+    SUBCASE("prepared strings") {
+        std::string const runtime = "{:>6}|{0:#x}|{1}";
+        prepared_format<> const prepared(format_string{runtime});
+        check(prepared, 255, "two");
+        check(NANOFMT_COMPILE("{} and {:>4}"), 'a', 12);
+        check(NANOFMT_COMPILE("{:*^7.2f}|{:#06x}|{:>3}"), 1.5, 255, standard_enum::two);
+
+        // custom formatters are parsed once per field, as through format_args
+        using tagged_formatter = formatter<tagged_type>;
+        std::string const tagged = "{:U}/{}";
+        prepared_format<> const tagged_prepared(format_string{tagged});
+        tagged_formatter::parse_count = 0;
+        char buffer[32];
+        format_inline_to(buffer, tagged_prepared, tagged_type{"a"}, tagged_type{"b"});
+        CHECK(std::strcmp(buffer, "TAG:a/tag:b") == 0);
+        format_inline_to(buffer, tagged_prepared, tagged_type{"c"}, tagged_type{"d"});
+        CHECK(std::strcmp(buffer, "TAG:c/tag:d") == 0);
+        CHECK(tagged_formatter::parse_count == 1);
+    }
+}
+
+TEST_CASE("nanofmt.format.dynamic") {
+    using namespace NANOFMT_NS;
+    using namespace NANOFMT_NS::test;
+
+    SUBCASE("width and precision") {
+        CHECK(sformat("{:{}}|", "ab", 5) == "ab   |");
+        CHECK(sformat("{:>{}}", 42, 6) == "    42");
+        CHECK(sformat("{:>{}}", "right", 7u) == "  right");
+        CHECK(sformat("{:.{}f}", 3.14159, 2) == "3.14");
+        CHECK(sformat("{:{}.{}f}", 3.14159, 8, 3) == sformat("{:8.3f}", 3.14159).buffer);
+        CHECK(sformat("{:.{}}", "truncated", 5ull) == sformat("{:.5}", "truncated").buffer);
+        CHECK(format_length("{:>{}}", 1, 10) == 10);
+    }
+
+    SUBCASE("indices") {
+        // nested automatic indices follow the field's own
+        CHECK(sformat("{:>{}}|{}", 1, 3, "x") == "  1|x");
+        CHECK(sformat("{0:>{2}}|{1:.{3}f}", 7, 2.25, 4, 1) == sformat("{:>4}|{:.1f}", 7, 2.25).buffer);
+        CHECK(sformat("{1:>{0}}", 5, 12) == "   12");
+    }
+
+    SUBCASE("invalid") {
+        CHECK(sformat("[{:{}}]", 1, -1) == "[]");
+        CHECK(sformat("[{:{}}]", 1, "wide") == "[]");
+        CHECK(sformat("[{:{}}]", 1) == "[]");
+        CHECK(sformat("[{:{}}]{}", 1, 2, 3) == "[ 1]3");
+
+        // a nested automatic index after an explicit index writes nothing,
+        // and formatting carries on after the field, on every path
+        std::string const mixed = "{:+}{1:.{}}|";
+        prepared_format<> const prepared(format_string{mixed});
+        CHECK(sformat(format_string{mixed}, 1.5f, 255u) == "+1.5|");
+        CHECK(sformat(prepared, 1.5f, 255u) == "+1.5|");
+        CHECK(sformat(NANOFMT_COMPILE("{:+}{1:.{}}|"), 1.5f, 255u) == "+1.5|");
+
+        char buffer[16];
+        format_inline_to(buffer, prepared, 1.5f, 255u);
+        CHECK(std::strcmp(buffer, "+1.5|") == 0);
+    }
+
+    SUBCASE("prepared and compiled") {
+        std::string const runtime = "{:>{}}|{:.{}f}|{}";
+        prepared_format<> const prepared(format_string{runtime});
+        CHECK(prepared.prepared());
+        CHECK(sformat(prepared, 42, 5, 1.25, 1, "end") == "   42|1.2|end");
+        CHECK(sformat(prepared, 42, 3, 1.25, 3, "end") == " 42|1.250|end");
+        CHECK(sformat(NANOFMT_COMPILE("{:>{}}|{:.{}f}|{}"), 42, 5, 1.25, 1, "end") == "   42|1.2|end");
+
+        char buffer[32];
+        format_inline_to(buffer, format_string{runtime}, 42, 5, 1.25, 1, "end");
+        CHECK(std::strcmp(buffer, "   42|1.2|end") == 0);
+        format_inline_to(buffer, prepared, 42, 5, 1.25, 1, "end");
+        CHECK(std::strcmp(buffer, "   42|1.2|end") == 0);
+    }
+}
+
+TEST_CASE("nanofmt.format.named") {
+    using namespace NANOFMT_NS;
+    using namespace NANOFMT_NS::test;
+
+    SUBCASE("names") {
+        CHECK(sformat("{user}@{host}", arg("user", "root"), arg("host", "example")) == "root@example");
+        CHECK(sformat("{b}{a}{b}", arg("a", 1), arg("b", 2)) == "212");
+        CHECK(sformat("{count:>4}|{ratio:.2f}", arg("count", 7), arg("ratio", 1.5)) == "   7|1.50");
+        CHECK(sformat("{_x1}", arg("_x1", 'c')) == "c");
+        CHECK(sformat("{v:U}", arg("v", tagged_type{"abc"})) == "TAG:abc");
+    }
+
+    SUBCASE("mixed with positions") {
+        // named arguments still take a position, and names don't affect
+        // automatic indexing
+        CHECK(sformat("{} {name} {}", arg("name", "n"), 2) == "n n 2");
+        CHECK(sformat("{1}-{name}", arg("name", 5), 6) == "6-5");
+        CHECK(sformat("{:>{width}}", 42, arg("width", 5)) == "   42");
+    }
+
+    SUBCASE("missing names") {
+        CHECK(sformat("[{missing}]", arg("name", 1)) == "[]");
+        CHECK(sformat("[{name}]", 1) == "[]");
+        CHECK(sformat("[{nam}]", arg("name", 1)) == "[]");
+
+        // a spec is skipped along with the field, on every path
+        CHECK(sformat("[{missing:>5}]|{w}", arg("w", 1)) == "[]|1");
+        CHECK(sformat("[{missing:>{w}}]|{w}", arg("w", 1)) == "[]|1");
+
+        char buffer[16];
+        *format_inline_to_n(buffer, sizeof buffer - 1, "[{missing:>5}]|{w}", arg("w", 1)) = '\0';
+        CHECK(std::strcmp(buffer, "[]|1") == 0);
+
+        prepared_format<> const prepared("[{missing:>5}]|{w}");
+        CHECK(sformat(prepared, arg("w", 1)) == "[]|1");
+    }
+
+    SUBCASE("many arguments") {
+        CHECK(
+            sformat(
+                "{last}{first}",
+                arg("first", 1),
+                2,
+                3,
+                4,
+                5,
+                6,
+                7,
+                8,
+                9,
+                10,
+                11,
+                12,
+                13,
+                14,
+                arg("last", 15)) == "151");
+    }
+
+    SUBCASE("prepared and compiled") {
+        std::string const runtime = "{user}:{id:>3}";
+        prepared_format<> const prepared(format_string{runtime});
+        CHECK(prepared.prepared());
+        CHECK(sformat(prepared, arg("id", 1), arg("user", "a")) == "a:  1");
+        CHECK(sformat(prepared, arg("user", "b"), arg("id", 22)) == "b: 22");
+        CHECK(sformat(prepared, arg("user", "c")) == "c:");
+        CHECK(sformat(NANOFMT_COMPILE("{user}:{id:>3}"), arg("user", "d"), arg("id", 4)) == "d:  4");
+
+        char buffer[32];
+        format_inline_to(buffer, format_string{runtime}, arg("user", "e"), arg("id", 5));
+        CHECK(std::strcmp(buffer, "e:  5") == 0);
+        format_inline_to(buffer, prepared, arg("id", 6), arg("user", "f"));
+        CHECK(std::strcmp(buffer, "f:  6") == 0);
+    }
+}
+
+TEST_CASE("nanofmt.format.sink") {
+    using namespace NANOFMT_NS;
+
+    struct collected {
+        std::string text;
+        int flushes = 0;
+    };
+    auto const collect = [](void* context, char const* data, std::size_t length) {
+        auto& into = *static_cast<collected*>(context);
+        into.text.append(data, length);
+        ++into.flushes;
+    };
+
+    // formats through a small chunk, and checks the result against an
+    // ordinary format into a buffer that is large enough
+    auto const check = [&collect](format_string fmt, auto const&... args) {
+        collected result;
+        char chunk[16];
+        format_sink sink(chunk, collect, &result);
+        format_output out = sink.output();
+        format_to(out, fmt, args...);
+        out.flush();
+        CHECK(result.text == test::sformat(fmt, args...).buffer);
+        CHECK(out.advance == result.text.size());
+        return result.flushes;
+    };
+
+    SUBCASE("chunks") {
+        CHECK(check("short {}", 1) == 1);
+        CHECK(check("a literal run that is longer than one chunk") == 3);
+        CHECK(check("{:>40}|{:<40}|", "right", -123456789) == 4);
+        CHECK(check("{}|{}|{}|{}|{}", 'a', true, nullptr, 0xffffu, "end") == 2);
+        CHECK(check("{:U}/{}", tagged_type{"sixteen chars.."}, custom_type{7}) > 1);
+        CHECK(check("{a}{b}{a}", arg("a", "0123456789"), arg("b", 1)) > 1);
+
+        // a formatter that writes through pos directly has a chunk of its
+        // own, and so isn't cut short by what the sink's chunk already holds
+        CHECK(check("0123456789{}|{}", direct_type{"abcdefgh"}, direct_type{"xyz"}) > 1);
+        CHECK(check("{}{}", direct_type{"longer than the sink's whole chunk"}, direct_type{"!"}) > 2);
+    }
+
+    SUBCASE("floats") {
+        // each value is written whole after the chunk is flushed, even if it
+        // would have fit only partly in what remained
+        CHECK(check("0123456789{}|{:.3e}", 3.14159, 1234.5) > 1);
+        CHECK(check("{:.8f}{:.8f}{:.8f}", 0.5, 0.25, 0.125) > 1);
+
+        // and a value longer than the whole chunk is streamed through it
+        CHECK(check("{:.40f}|{:e}", 1.0 / 3.0, 1e100) > 3);
+
+        // precision past what scratch holds is streamed as trailing zeros
+        collected result;
+        char chunk[8];
+        format_sink sink(chunk, collect, &result);
+        format_output out = sink.output();
+        double const inf = std::numeric_limits<double>::infinity();
+        format_to(out, "{:.2000f}|{:.1500e}|{:.1200f}|{}", 1.0, 1.0, inf, 7);
+        out.flush();
+        CHECK(result.text == "1." + std::string(2000, '0') + "|1." + std::string(1500, '0') + "e+00|inf|7");
+        CHECK(out.advance == result.text.size());
+        CHECK(format_length("{:.2000f}|{:.1500e}|{:.1200f}|{}", 1.0, 1.0, inf, 7) == result.text.size());
+    }
+
+    SUBCASE("flush") {
+        collected result;
+        char chunk[4];
+        format_sink sink(chunk, collect, &result);
+        format_output out = sink.output();
+        out.append("abc").put('d');
+        CHECK(result.flushes == 0);
+        out.put('e').fill_n('-', 6).append("xyz", 3);
+        CHECK(result.text == "abcde------x");
+        out.flush();
+        out.flush();
+        CHECK(result.text == "abcde------xyz");
+        CHECK(result.flushes == 4);
+        CHECK(out.advance == 14);
+    }
+
+    SUBCASE("discard") {
+        // characters are dropped from the front of the output, whether they
+        // are appended or written directly
+        collected result;
+        char chunk[4];
+        format_sink sink(chunk, collect, &result);
+        sink.discard = 9;
+        format_output out = sink.output();
+        out.fill_n('-', 3).append("abc", 3);
+        *out.pos = '#';
+        out.advance_to(out.pos + 1).put('d').append("efgh").put('i');
+        out.flush();
+        CHECK(result.text == "fghi");
+        CHECK(out.advance == 13);
+        CHECK(sink.discard == 0);
+
+        collected floats;
+        char float_chunk[16];
+        format_sink float_sink(float_chunk, collect, &floats);
+        float_sink.discard = 40;
+        format_output float_out = float_sink.output();
+        format_to(float_out, "{:.50f}|{:.3f}", 0.5, 0.25);
+        float_out.flush();
+        CHECK(floats.text == std::string(12, '0') + "|0.250");
+    }
+
+    SUBCASE("end") {
+        // a callback that clears the chunk ends the output, which is then
+        // only counted
+        collected result;
+        char chunk[4];
+        format_sink sink(chunk, collect, &result);
+        sink.context = &sink;
+        sink.callback = [](void* context, char const*, std::size_t) {
+            static_cast<format_sink*>(context)->chunk = nullptr;
+        };
+        format_output out = sink.output();
+        format_to(out, "{:>100000}|{}|{:.3f}|{:.50f}", 7, "text", 1.5, 0.5);
+        CHECK(out.full());
+        CHECK(out.advance == 100000 + 6 + 6 + 52);
+        CHECK(out.flush().advance == out.advance);
+    }
+}
+
+TEST_CASE("nanofmt.format.cursor") {
+    using namespace NANOFMT_NS;
+
+    // writes the whole output in frames of every size from 1 up, and checks
+    // that the frames join up to match an ordinary format
+    auto const check = [](format_string fmt, auto const&... args) {
+        auto const expected = test::sformat(fmt, args...);
+        for (std::size_t frame_size = 1; frame_size <= expected.size + 1; ++frame_size) {
+            format_cursor cursor(fmt, args...);
+            std::string joined;
+            int frames = 0;
+            while (!cursor.done() && frames <= 1000) {
+                char frame[128];
+                char const* const end = cursor.format_to_n(frame, frame_size);
+                joined.append(frame, end - frame);
+                ++frames;
+            }
+            CHECK(joined == expected.buffer);
+            if (joined != expected.buffer) {
+                return;
+            }
+        }
+    };
+
+    SUBCASE("text") {
+        check("");
+        check("literal text only");
+        check("{{escaped}} {{{{braces}}");
+        check("unterminated {");
+    }
+
+    SUBCASE("fields") {
+        check("{} and {}", 1, 2);
+        check("[{:>12}] [{:<12}] [{:^12}]", "right", "left", "center");
+        check("{:#x}|{:+08d}|{:b}", 48879, -42, 5u);
+        check("{0}{1}{0}", "ab", 'c');
+        check("{:.3f} {:e} {}", 3.14159, 1234.5, 0.1);
+        check("{} / {:U}", custom_type{12}, tagged_type{"tagged"});
+
+        // a formatter writing through pos directly resumes mid-field too
+        check("<{}|{}>", direct_type{"abcdefghijklmnopqrstuvwxyz"}, direct_type{"0123456789"});
+    }
+
+    SUBCASE("dynamic and named") {
+        check("{:>{}}|{}", 42, 9, "after");
+        check("{user}@{host}:{port:>6}", arg("port", 22), arg("host", "example.com"), arg("user", "root"));
+    }
+
+    SUBCASE("early end") {
+        check("{0} {}", 1, 2);
+    }
+
+    SUBCASE("long fields") {
+        // fields spanning many frames resume where each frame ended
+        std::string const text(5000, 's');
+        std::string const expected = std::string(99999, ' ') + "7|" + text + std::string(1000, ' ') + "|0.5" +
+            std::string(1499, '0') + "|custom{3}";
+
+        custom_type const custom{3};
+        for (std::size_t const frame_size : {1400, 61}) {
+            format_cursor cursor("{:{}}|{:<6000}|{:.1500f}|{}", 7, 100000, text.c_str(), 0.5, custom);
+            std::string joined;
+            std::size_t frames = 0;
+            while (!cursor.done() && frames <= expected.size()) {
+                char frame[1400];
+                char const* const end = cursor.format_to_n(frame, frame_size);
+                joined.append(frame, end - frame);
+                ++frames;
+            }
+            CHECK(joined == expected);
+            CHECK(frames == (expected.size() + frame_size - 1) / frame_size);
+        }
+    }
+
+    SUBCASE("frames") {
+        format_cursor cursor("{}: {:>10}!", "message", 7);
+        char frame[8];
+        char const* end = cursor.format_to_n(frame, sizeof frame);
+        CHECK(std::string(frame, end - frame) == "message:");
+        CHECK(!cursor.done());
+        end = cursor.format_to_n(frame, sizeof frame);
+        CHECK(std::string(frame, end - frame) == "        ");
+        end = cursor.format_to_n(frame, sizeof frame);
+        CHECK(std::string(frame, end - frame) == "  7!");
+        CHECK(cursor.done());
+        CHECK(cursor.format_to_n(frame, sizeof frame) == frame);
+    }
+}
+
+TEST_CASE("nanofmt.format.result") {
+    using namespace NANOFMT_NS;
+
+    SUBCASE("fits") {
+        char buffer[32];
+        format_result const result = format_to_n_result(buffer, sizeof buffer, "{}-{:>4}", "ab", 12);
+        CHECK(result.pos == buffer + 7);
+        CHECK(result.size == 7);
+        CHECK(std::string(buffer, result.pos - buffer) == "ab-  12");
+    }
+
+    SUBCASE("truncated") {
+        char buffer[4];
+        format_result const result = format_to_n_result(buffer, sizeof buffer, "{}:{}", "value", 123456);
+        CHECK(result.pos == buffer + 4);
+        CHECK(result.size == 12);
+        CHECK(std::string(buffer, 4) == "valu");
+
+        // retry with a buffer of the reported size
+        std::string retry(result.size, '\0');
+        CHECK(format_to_n_result(retry.data(), retry.size(), "{}:{}", "value", 123456).size == 12);
+        CHECK(retry == "value:123456");
+    }
+
+    SUBCASE("floats") {
+        // a value cut short still counts in full
+        char buffer[4];
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:.3f}", 3.14159).size == 5);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "x{}y", 1234.5678).size == 9);
+        CHECK(format_to_n_result(buffer, 0, "{:e}", 1.0).size == 12);
+        CHECK(format_length("{:.2f}|{}", 2.5, 0.1) == 8);
+    }
+
+    SUBCASE("arrays") {
+        char buffer[6];
+        format_result const result = format_to_result(buffer, "{}{}", 12345, 678);
+        CHECK(result.pos == buffer + 5);
+        CHECK(*result.pos == '\0');
+        CHECK(result.size == 8);
+        CHECK(std::strcmp(buffer, "12345") == 0);
+
+        CHECK(vformat_to_n_result(buffer, sizeof buffer, "{}", make_format_args(true)).size == 4);
+        CHECK(vformat_to_result(buffer, "{}", make_format_args("abc")).size == 3);
+        CHECK(std::strcmp(buffer, "abc") == 0);
+    }
+}
+
 TEST_CASE("nanofmt.format.length") {
     using namespace NANOFMT_NS;
 
@@ -248,6 +935,80 @@ TEST_CASE("nanofmt.format.length") {
 
     // https://github.com/seanmiddleditch/nanofmt/issues/49
     CHECK(format_length("{0} = 0x{0:X} = 0b{0:b}", 28) == 19);
+
+    // the measured length is always that of the formatted output
+    auto const matches = [](format_string format_str, auto const&... args) {
+        char buffer[256];
+        char const* const end = format_to_n(buffer, sizeof buffer, format_str, args...);
+        return format_length(format_str, args...) == static_cast<std::size_t>(end - buffer);
+    };
+
+    SUBCASE("integers") {
+        for (long long value : {0ll, 1ll, -1ll, 7ll, 8ll, 10ll, -99ll, 100ll, 255ll, 256ll, -4096ll, 1234567890ll}) {
+            CHECK(matches("{}", value));
+            CHECK(matches("{:d}|{:x}|{:X}|{:b}|{:B}|{:o}", value, value, value, value, value, value));
+            CHECK(matches("{:#x}|{:#X}|{:#b}|{:#B}|{:#o}", value, value, value, value, value));
+            CHECK(matches("{:+}|{: }|{:08}|{:+08}|{:#010x}", value, value, value, value, value));
+            CHECK(matches("{:>12}|{:*<12}|{:^12}|{:*>12x}", value, value, value, value));
+            CHECK(matches("{:.2}|{:.1}|{:#.3x}|{:-.1}", value, value, value, value));
+        }
+        constexpr long long lowest = std::numeric_limits<long long>::min();
+        constexpr unsigned long long highest = std::numeric_limits<unsigned long long>::max();
+        CHECK(matches("{0}|{0:x}|{0:b}|{1}|{1:#o}", lowest, highest));
+        CHECK(matches("{}|{:d}|{:x}|{:c}", true, false, 'a', 'b'));
+    }
+
+    SUBCASE("strings and pointers") {
+        CHECK(matches("{}|{:8}|{:<8}|{:>8}|{:^8}|{:2}", "abc", "abc", "abc", "abc", "abc", "abc"));
+        CHECK(matches("{}|{}", static_cast<void const*>(nullptr), static_cast<void const*>(&matches)));
+    }
+
+    SUBCASE("floats") {
+        CHECK(matches("{}|{:+}|{: .3f}|{:e}|{:g}|{:a}", 1.5, 2.25, -0.125, 12345.678, 1e-7, 0.1f));
+    }
+
+    SUBCASE("custom") {
+        formatter<tagged_type>::measure_count = 0;
+        CHECK(format_length("{}-{:U}", tagged_type{"ab"}, tagged_type{"cde"}) == 14);
+        CHECK(formatter<tagged_type>::measure_count == 2);
+        CHECK(matches("{}", tagged_type{"ab"}));
+        CHECK(formatter<tagged_type>::measure_count == 3);
+        CHECK(matches("{}", custom_type{42}));
+    }
+}
+
+TEST_CASE("nanofmt.format.saturated") {
+    using namespace NANOFMT_NS;
+
+    // padding and digits that cannot be written cost nothing, so these run
+    // in microseconds rather than the seconds a loop over each would take
+    auto const start = std::chrono::steady_clock::now();
+
+    char buffer[8];
+    for (int repeat = 0; repeat != 20; ++repeat) {
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:999999999}", 1).size == 999'999'999);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:0999999999}", -1).size == 999'999'999);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:^999999999}", "abc").size == 999'999'999);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:>{}}", "abc", 2147483647).size == 2'147'483'647);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:.999999999f}", 1.5).size == 1'000'000'001);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:.999999999e}", 1.5).size == 1'000'000'005);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:.999999999a}", 1.5).size == 1'000'000'004);
+        CHECK(format_to_n_result(buffer, sizeof buffer, "{:.999999999g}", 1.5).size == 3);
+        CHECK(format_length("{:999999999}|{:.999999999f}", "x", 0.1) == 2'000'000'001);
+    }
+
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed < std::chrono::seconds(1));
+
+    SUBCASE("exact precision") {
+        // the smallest subnormal has more digits than are generated to measure
+        // a float, past which only zeros are counted
+        char large[2048];
+        char const* const end = format_to_n(large, sizeof large, "{:.1500f}", 4.9406564584124654e-324);
+        CHECK(end - large == 1502);
+        CHECK(format_length("{:.1500f}", 4.9406564584124654e-324) == 1502);
+        CHECK(format_length("{:.1500e}", 4.9406564584124654e-324) == 1507);
+    }
 }
 
 // TEST_CASE("nanofmt.format.compile_error") {
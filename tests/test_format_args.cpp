@@ -9,7 +9,7 @@
 namespace {
     template <typename T>
     constexpr auto to_arg(T const& value) noexcept {
-        return ::NANOFMT_NS::make_format_args(value).values[0];
+        return ::NANOFMT_NS::format_args(::NANOFMT_NS::make_format_args(value)).get(0);
     }
 } // namespace
 
@@ -139,3 +139,49 @@ TEST_CASE("nanofmt.format_arg.custom") {
         CHECK(to_arg(cct).tag == format_arg::type::t_custom);
     }
 }
+
+TEST_CASE("nanofmt.format_args.storage") {
+    using namespace NANOFMT_NS;
+    using namespace NANOFMT_NS::test;
+
+    static_assert(sizeof(detail::format_value) == 8);
+
+    SUBCASE("packed") {
+        custom::struct_type const st;
+        custom::class_type const ct;
+        auto store = make_format_args(1, st, 'c', ct, 2.0);
+        static_assert(decltype(store)::packed);
+        static_assert(sizeof(store.values) == sizeof(detail::format_value) * 8);
+
+        format_args const args(static_cast<decltype(store)&&>(store));
+        CHECK(args.get(0).v_int == 1);
+        CHECK(args.get(1).tag == format_arg::type::t_custom);
+        CHECK(args.get(1).v_custom.value == &st);
+        CHECK(args.get(2).v_char == 'c');
+        CHECK(args.get(3).tag == format_arg::type::t_custom);
+        CHECK(args.get(3).v_custom.value == &ct);
+        CHECK(args.get(1).v_custom.thunk != args.get(3).v_custom.thunk);
+        CHECK(args.get(4).v_double == 2.0);
+        CHECK(args.get(5).tag == format_arg::type::t_mono);
+    }
+
+    SUBCASE("unpacked") {
+        auto store = make_format_args(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 'a', 'b', 'c', 'd', 'e', 'f');
+        static_assert(!decltype(store)::packed);
+
+        format_args const args(static_cast<decltype(store)&&>(store));
+        CHECK(args.get(9).v_int == 9);
+        CHECK(args.get(15).v_char == 'f');
+        CHECK(args.get(16).tag == format_arg::type::t_mono);
+    }
+
+    SUBCASE("formatting") {
+        CHECK(
+            sformat("{}{}{}{}{}{}{}{}{}{}{}{}{}{}", 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 'a', 'b', 'c', 'd') ==
+            "0123456789abcd");
+        CHECK(
+            sformat("{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}", 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 'a', 'b', 'c', 'd', 'e', 'f') ==
+            "0123456789abcdef");
+        CHECK(sformat("{15}{0}", 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 'a', 'b', 'c', 'd', 'e', 'f') == "f0");
+    }
+}
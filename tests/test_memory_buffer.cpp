@@ -0,0 +1,126 @@
+// Copyright (c) Sean Middleditch and contributors. See accompanying LICENSE.md for copyright details.
+
+#include "test_utils.h"
+
+#include "nanofmt/memory_buffer.h"
+
+#include <doctest/doctest.h>
+
+#include <string>
+
+namespace {
+    struct counting_allocator {
+        int* allocations = nullptr;
+        int* live = nullptr;
+
+        char* allocate(std::size_t size) noexcept {
+            ++*allocations;
+            ++*live;
+            return new char[size];
+        }
+        void deallocate(char* memory, std::size_t) noexcept {
+            --*live;
+            delete[] memory;
+        }
+    };
+
+    // has room for a limited number of bytes in total, then fails
+    struct limited_allocator {
+        std::size_t remaining = 0;
+
+        char* allocate(std::size_t size) noexcept {
+            if (size > remaining) {
+                return nullptr;
+            }
+            remaining -= size;
+            return new char[size];
+        }
+        void deallocate(char* memory, std::size_t) noexcept { delete[] memory; }
+    };
+
+    template <typename BufferT>
+    std::string contents(BufferT const& buffer) {
+        return std::string(buffer.data(), buffer.size());
+    }
+} // namespace
+
+TEST_CASE("nanofmt.memory_buffer.inline") {
+    using namespace NANOFMT_NS;
+
+    int allocations = 0;
+    int live = 0;
+    {
+        basic_memory_buffer<32, counting_allocator> buffer(counting_allocator{&allocations, &live});
+        buffer.format("{}-{:>5}", "abc", 42).format("|{:.2f}", 1.5);
+        CHECK(contents(buffer) == "abc-   42|1.50");
+        CHECK(buffer.capacity() == 32);
+        CHECK_FALSE(buffer.truncated);
+    }
+    CHECK(allocations == 0);
+
+    memory_buffer buffer;
+    buffer.append("ab", 2).format("{}", 'c');
+    CHECK(contents(buffer) == "abc");
+
+    buffer.clear();
+    CHECK(buffer.size() == 0);
+    buffer.format("{}", 7);
+    CHECK(contents(buffer) == "7");
+}
+
+TEST_CASE("nanofmt.memory_buffer.growth") {
+    using namespace NANOFMT_NS;
+
+    int allocations = 0;
+    int live = 0;
+    {
+        basic_memory_buffer<8, counting_allocator> buffer(counting_allocator{&allocations, &live});
+
+        // each field crosses into newly grown storage
+        std::string expected;
+        for (int index = 0; index != 100; ++index) {
+            buffer.format("{:>6}|", index);
+            expected += std::string(6 - std::to_string(index).size(), ' ') + std::to_string(index) + "|";
+        }
+        CHECK(contents(buffer) == expected);
+        CHECK(buffer.capacity() >= buffer.size());
+
+        // geometric growth allocates a handful of times, not once per write
+        CHECK(allocations <= 8);
+        CHECK(live == 1);
+
+        std::string const long_text(1000, 'x');
+        buffer.clear();
+        buffer.format("{}{:e}{:.300f}", long_text.c_str(), 1.0, 0.5);
+        CHECK(buffer.size() == 1000 + 12 + 302);
+        CHECK(contents(buffer).substr(1000, 12) == "1.000000e+00");
+
+        // a float longer than the formatter's scratch still arrives whole
+        buffer.clear();
+        buffer.format("{:.3000f}", 1.0);
+        CHECK(buffer.size() == format_length("{:.3000f}", 1.0));
+        CHECK(contents(buffer) == "1." + std::string(3000, '0'));
+        CHECK_FALSE(buffer.truncated);
+
+        buffer.clear();
+        buffer.append(long_text.data(), long_text.size()).append(long_text.data(), long_text.size());
+        CHECK(contents(buffer) == long_text + long_text);
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("nanofmt.memory_buffer.allocation_failure") {
+    using namespace NANOFMT_NS;
+
+    basic_memory_buffer<4, limited_allocator> buffer(limited_allocator{8});
+    buffer.format("{}", "0123456789abcdef");
+    CHECK(buffer.truncated);
+    CHECK(contents(buffer) == "01234567");
+
+    buffer.clear();
+    buffer.append("abc", 3);
+    CHECK_FALSE(buffer.truncated);
+    buffer.append("defghi", 6);
+    CHECK(buffer.truncated);
+    CHECK(contents(buffer) == "abcdefgh");
+}
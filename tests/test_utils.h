@@ -43,4 +43,21 @@ namespace NANOFMT_NS::test {
         result.size = end - result.buffer;
         return result;
     }
+
+    template <typename ValueT>
+    struct parse_result {
+        ValueT value = {};
+        from_chars_error ec = from_chars_error::none;
+        std::size_t length = 0;
+    };
+
+    template <typename ValueT, typename... ArgsT>
+    auto parse(char const* zstr, ArgsT&&... args) {
+        parse_result<ValueT> result;
+        char const* const end = zstr + std::strlen(zstr);
+        from_chars_result const parsed = ::NANOFMT_NS::from_chars(zstr, end, result.value, args...);
+        result.ec = parsed.ec;
+        result.length = parsed.ptr - zstr;
+        return result;
+    }
 } // namespace NANOFMT_NS::test